@@ -1,121 +1,855 @@
 #include "AIPlayer.h"
 #include <algorithm>
 #include <climits>
+#include <cstdlib>
 
-int AIPlayer::getBestMove(const GameState& currentState) {
-    // First check for immediate winning moves
-    for (int col = 0; col < 7; col++) {
-        if (isWinningMove(currentState, col)) {
-            return col;
-        }
+namespace {
+
+// Opening books only exist for the standard board
+int lookupBook(const OpeningBook& book, const Bitboard& board) {
+    return book.lookup(board);
+}
+
+template <class Board>
+int lookupBook(const OpeningBook&, const Board&) {
+    return -1;
+}
+
+}
+
+template <class Board>
+int BasicAIPlayer<Board>::getBestMove(const GameState& currentState) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    transpositionTable.newSearch();
+    timeLimited = false;
+    lastStats.reset();
+    
+    // First check for immediate winning or blocking moves
+    int immediateMove = findImmediateMove(currentState);
+    if (immediateMove != -1) {
+        return unsearchedMove(currentState, immediateMove);
     }
     
-    // Then check for moves that block opponent's winning moves
-    for (int col = 0; col < 7; col++) {
-        if (isBlockingMove(currentState, col)) {
-            return col;
-        }
+    int bookMove = findBookMove(currentState);
+    if (bookMove != -1) {
+        return unsearchedMove(currentState, bookMove);
     }
     
     // Use minimax for deeper analysis
-    int bestMove = 3; // Default to center column
+    vector<int> possibleMoves = getRootMoves(currentState);
+    int bestMove = possibleMoves.empty() ? Board::WIDTH / 2 : possibleMoves[0];
     int bestScore = INT_MIN;
     
-    vector<int> possibleMoves = getPossibleMoves(currentState);
+    // Helper threads warm the shared table while this thread does the real
+    // search. Without a deadline only stop() interrupts it; the root move
+    // being searched then is left out.
+    startHelpers(currentState, possibleMoves, maxDepth);
+    SearchContext ctx(0);
     
     for (int move : possibleMoves) {
-        int score = evaluateMove(currentState, move);
+        int score = searchMove(ctx, currentState, move, maxDepth);
+        if (stopping()) {
+            break;
+        }
         if (score > bestScore) {
             bestScore = score;
             bestMove = move;
         }
     }
     
+    stopHelpers(ctx);
+    lastStats.score = possibleMoves.empty() ? 0 : bestScore;
+    lastStats.depth = maxDepth;
+    lastStats.bestMove = bestMove;
+    lastStats.principalVariation = principalVariation(currentState, bestMove, maxDepth);
+    lastStats.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    SEARCH_TRACE_ITERATION(traceSink, lastStats);
     return bestMove;
 }
 
-int AIPlayer::bfsEvaluate(const GameState& startState) {
-    queue<GameState> bfsQueue;
-    unordered_set<GameState, GameStateHash, GameStateEqual> visited;
+template <class Board>
+int BasicAIPlayer<Board>::getBestMove(const GameState& currentState, chrono::milliseconds timeBudget) {
+    return getBestMove(currentState, timeBudget, Board::WIDTH * Board::HEIGHT);
+}
+
+template <class Board>
+int BasicAIPlayer<Board>::getBestMove(const GameState& currentState, chrono::milliseconds timeBudget, int depthLimit) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    transpositionTable.newSearch();
+    lastStats.reset();
     
-    bfsQueue.push(startState);
-    visited.insert(startState);
+    int immediateMove = findImmediateMove(currentState);
+    if (immediateMove != -1) {
+        return unsearchedMove(currentState, immediateMove);
+    }
     
-    int bestScore = INT_MIN;
-    int nodesExplored = 0;
+    int bookMove = findBookMove(currentState);
+    if (bookMove != -1) {
+        return unsearchedMove(currentState, bookMove);
+    }
+    
+    vector<int> rootMoves = getRootMoves(currentState);
+    if (rootMoves.empty()) {
+        return Board::WIDTH / 2;
+    }
+    
+    int bestMove = rootMoves[0];
+    int maxPlies = min(depthLimit, Board::WIDTH * Board::HEIGHT - currentState.getBoard().getMoveCount());
+    
+    deadline = start + timeBudget;
+    timeLimited = true;
+    startHelpers(currentState, rootMoves, maxPlies);
+    SearchContext ctx(0);
+    
+    for (int depth = 1; depth <= maxPlies; depth++) {
+        // The first iteration always completes so there is a move to return
+        ctx.interruptible = depth > 1;
+        
+        vector<pair<int, int>> scoredMoves;
+        for (int move : rootMoves) {
+            int score = searchMove(ctx, currentState, move, depth);
+            if (ctx.interruptible && stopping()) {
+                break;
+            }
+            scoredMoves.push_back(make_pair(score, move));
+        }
+        if (ctx.interruptible && stopping()) {
+            break;
+        }
+        
+        // Order the next iteration by this one's scores, best line first;
+        // deeper in the tree the stored best moves replay the principal variation
+        stable_sort(scoredMoves.begin(), scoredMoves.end(),
+                    [](const pair<int, int>& a, const pair<int, int>& b) { return a.first > b.first; });
+        for (size_t i = 0; i < scoredMoves.size(); i++) {
+            rootMoves[i] = scoredMoves[i].second;
+        }
+        bestMove = rootMoves[0];
+        lastStats.score = scoredMoves[0].first;
+        lastStats.depth = depth;
+        SEARCH_TRACE_ITERATION(traceSink, iterationStats(ctx, currentState, start, depth, lastStats.score, bestMove));
+        
+        // A deeper iteration costs several times the previous one; skip it
+        // when it clearly cannot finish before the deadline
+        chrono::steady_clock::duration elapsed = chrono::steady_clock::now() - start;
+        if (elapsed * 2 > timeBudget) {
+            break;
+        }
+    }
+    
+    stopHelpers(ctx);
+    timeLimited = false;
+    lastStats.bestMove = bestMove;
+    lastStats.principalVariation = principalVariation(currentState, bestMove, lastStats.depth);
+    lastStats.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return bestMove;
+}
+
+template <class Board>
+int BasicAIPlayer<Board>::findImmediateMove(const GameState& state) {
+    // First check for immediate winning moves
+    for (int col = 0; col < Board::WIDTH; col++) {
+        if (isWinningMove(state, col)) {
+            return col;
+        }
+    }
+    
+    // Then check for moves that block opponent's winning moves
+    for (int col = 0; col < Board::WIDTH; col++) {
+        if (isBlockingMove(state, col)) {
+            return col;
+        }
+    }
+    
+    return -1;
+}
+
+template <class Board>
+int BasicAIPlayer<Board>::findBookMove(const GameState& state) const {
+    // Book moves are stored for the player to move, which must be this player
+    if (!openingBook || state.getLastPlayer() == playerSymbol) {
+        return -1;
+    }
+    
+    int move = lookupBook(*openingBook, state.getBoard());
+    if (move == -1 || !state.getBoard().canPlay(move)) {
+        return -1;
+    }
+    return move;
+}
+
+template <class Board>
+int BasicAIPlayer<Board>::unsearchedMove(const GameState& state, int move) {
+    lastStats.score = fromOwnView(state.makeMove(move, playerSymbol).evaluateState());
+    lastStats.depth = 0;
+    lastStats.bestMove = move;
+    lastStats.principalVariation.assign(1, move);
+    return move;
+}
+
+template <class Board>
+vector<int> BasicAIPlayer<Board>::getRootMoves(const GameState& state) {
+    vector<int> moves = getPossibleMoves(state);
+    if (state.getBoard().isSymmetric()) {
+        moves.erase(remove_if(moves.begin(), moves.end(), [](int col) { return col > (Board::WIDTH - 1) / 2; }),
+                    moves.end());
+    }
+    return moves;
+}
+
+template <class Board>
+vector<int> BasicAIPlayer<Board>::principalVariation(const GameState& state, int firstMove, int depth) {
+    vector<int> line;
+    SearchPosition pos(state);
+    if (!pos.canPlay(firstMove)) {
+        return line;
+    }
+    pos.play(firstMove, playerSymbol);
+    line.push_back(firstMove);
+    
+    // The root is not stored, but every position below it is
+    bool isMaximizing = false;
+    while (static_cast<int>(line.size()) < depth && !pos.isWinningState() && !pos.isDrawState()) {
+        TTEntry entry;
+        if (!transpositionTable.probe(positionKey(pos, isMaximizing), entry)) {
+            break;
+        }
+        int move = tableMove(pos, entry.bestMove);
+        if (!pos.canPlay(move)) {
+            break;
+        }
+        pos.play(move, isMaximizing ? playerSymbol : opponentSymbol);
+        line.push_back(move);
+        isMaximizing = !isMaximizing;
+    }
+    return line;
+}
+
+template <class Board>
+SearchStats BasicAIPlayer<Board>::iterationStats(const SearchContext& ctx, const GameState& state,
+                                     chrono::steady_clock::time_point start, int depth, int score, int bestMove) {
+    SearchStats stats = ctx.stats;
+    stats.depth = depth;
+    stats.score = score;
+    stats.bestMove = bestMove;
+    stats.principalVariation = principalVariation(state, bestMove, depth);
+    stats.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::ensureHelpers() {
+    // Keep the threads of the previous job unless the thread count changed
+    int count = threadCount - 1;
+    if (static_cast<int>(helpers.size()) != count) {
+        shutdownHelpers();
+        helperContexts.resize(count);
+        for (int i = 0; i < count; i++) {
+            helpers.push_back(thread(&BasicAIPlayer::helperLoop, this, i, helperJob));
+        }
+    }
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::startHelpers(const GameState& state, const vector<int>& rootMoves, int depthLimit) {
+    ensureHelpers();
+    int count = static_cast<int>(helpers.size());
+    if (count == 0) {
+        return;
+    }
+    
+    lock_guard<mutex> lock(helperMutex);
+    for (int i = 0; i < count; i++) {
+        helperContexts[i] = SearchContext(i + 1);
+    }
+    jobState = state;
+    jobRootMoves = rootMoves;
+    jobDepthLimit = depthLimit;
+    jobWork = nullptr;
+    busyHelpers = count;
+    helperJob++;
+    helperWake.notify_all();
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::stopHelpers(const SearchContext& mainContext) {
+    stopSearch = true;
+    {
+        unique_lock<mutex> lock(helperMutex);
+        helperIdle.wait(lock, [this]() { return busyHelpers == 0; });
+    }
+    stopSearch = false;
+    
+    lastStats.merge(mainContext.stats);
+    for (const SearchContext& ctx : helperContexts) {
+        lastStats.merge(ctx.stats);
+    }
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::runOnHelpers(void (*work)(void*, int), void* data) {
+    ensureHelpers();
+    int count = static_cast<int>(helpers.size());
+    if (count > 0) {
+        lock_guard<mutex> lock(helperMutex);
+        jobWork = work;
+        jobData = data;
+        busyHelpers = count;
+        helperJob++;
+        helperWake.notify_all();
+    }
     
-    while (!bfsQueue.empty() && nodesExplored < 1000) { // Limit exploration
-        GameState current = bfsQueue.front();
-        bfsQueue.pop();
-        nodesExplored++;
+    work(data, 0);
+    
+    if (count > 0) {
+        unique_lock<mutex> lock(helperMutex);
+        helperIdle.wait(lock, [this]() { return busyHelpers == 0; });
+        jobWork = nullptr;
+    }
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::helperLoop(int index, unsigned job) {
+    unique_lock<mutex> lock(helperMutex);
+    while (true) {
+        helperWake.wait(lock, [this, job]() { return helpersExit || helperJob != job; });
+        if (helpersExit) {
+            return;
+        }
+        job = helperJob;
+        GameState state = jobState;
+        vector<int> rootMoves = jobRootMoves;
+        int depthLimit = jobDepthLimit;
+        void (*work)(void*, int) = jobWork;
+        void* data = jobData;
         
-        // Evaluate current state
-        int currentScore = current.evaluateState();
-        if (currentScore > bestScore) {
-            bestScore = currentScore;
+        lock.unlock();
+        if (work) {
+            work(data, index + 1);
+        } else {
+            runHelper(helperContexts[index], state, rootMoves, depthLimit);
         }
+        lock.lock();
         
-        // If we've reached max depth, don't explore further
-        if (current.getDepth() >= maxDepth) {
+        if (--busyHelpers == 0) {
+            helperIdle.notify_all();
+        }
+    }
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::shutdownHelpers() {
+    {
+        lock_guard<mutex> lock(helperMutex);
+        helpersExit = true;
+    }
+    helperWake.notify_all();
+    for (thread& helper : helpers) {
+        helper.join();
+    }
+    helpers.clear();
+    helperContexts.clear();
+    helpersExit = false;
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::runHelper(SearchContext& ctx, GameState state, vector<int> rootMoves, int depthLimit) {
+    if (rootMoves.empty()) {
+        return;
+    }
+    
+    // Vary the root order and starting depth per thread so helpers
+    // explore different parts of the tree and share results through the table
+    rotate(rootMoves.begin(), rootMoves.begin() + ctx.threadId % rootMoves.size(), rootMoves.end());
+    
+    for (int depth = 1 + ctx.threadId % 2; depth <= depthLimit; depth++) {
+        for (int move : rootMoves) {
+            searchMove(ctx, state, move, depth);
+            if (stopping()) {
+                return;
+            }
+        }
+    }
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::startPondering(const GameState& state) {
+    stopPondering();
+    if (state.isWinningState() || state.isDrawState()) {
+        return;
+    }
+    
+    // The flag is cleared here rather than in the thread, so a stop
+    // requested right after starting cannot be lost
+    stopSearch = false;
+    timeLimited = false;
+    ponderThread = thread(&BasicAIPlayer::ponder, this, state);
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::stopPondering() {
+    if (ponderThread.joinable()) {
+        stopSearch = true;
+        ponderThread.join();
+        stopSearch = false;
+    }
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::ponder(GameState state) {
+    transpositionTable.newSearch();
+    SearchContext ctx(0);
+    SearchPosition pos(state);
+    
+    // Expected reply first: the move the last search stored for this position
+    TTEntry entry;
+    int ttMove = transpositionTable.probe(positionKey(pos, false), entry) ? tableMove(pos, entry.bestMove) : -1;
+    int replies[Board::WIDTH];
+    int replyCount = orderMoves(ctx, pos, replies, ttMove, false);
+    
+    // On a symmetric board a reply and its mirror image share table entries
+    if (state.getBoard().isSymmetric()) {
+        replyCount = static_cast<int>(remove_if(replies, replies + replyCount,
+                                                [](int col) { return col > (Board::WIDTH - 1) / 2; }) - replies);
+    }
+    
+    // Deepen all replies together until stopped, so whichever move the
+    // opponent makes has been searched about as deeply as the others
+    int maxPlies = Board::WIDTH * Board::HEIGHT - state.getBoard().getMoveCount() - 1;
+    for (int depth = 1; depth <= maxPlies; depth++) {
+        for (int i = 0; i < replyCount; i++) {
+            GameState reply = state.makeMove(replies[i], opponentSymbol);
+            if (reply.isWinningState() || reply.isDrawState()) {
+                continue;
+            }
+            for (int move : getPossibleMoves(reply)) {
+                searchMove(ctx, reply, move, depth);
+                if (stopping()) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+template <class Board>
+int BasicAIPlayer<Board>::expandBfsEntry(const BfsEntry& entry, char player, BfsEntry* out) const {
+    Word xStones = entry.key - entry.mask;
+    int count = 0;
+    for (int col = 0; col < Board::WIDTH; col++) {
+        if (entry.mask & Board::topMask(col)) {
             continue;
         }
         
-        // Generate next states
-        char nextPlayer = (current.getLastPlayer() == 'X') ? 'O' : 'X';
-        vector<GameState> nextStates = current.generateNextStates(nextPlayer);
+        Word move = (entry.mask + Board::bottomMask(col)) & Board::columnMask(col);
+        int heuristic = entry.value + BasicEvaluator<Board>::moveDelta(xStones ^ entry.mask, xStones, move, player);
+        Word childX = (player == 'X') ? xStones | move : xStones;
+        Word childMask = entry.mask | move;
+        
+        BfsEntry& child = out[count++];
+        child.terminal = true;
+        if (Board::hasAlignment(player == 'X' ? childX : childX ^ childMask)) {
+            child.value = (player == 'O') ? 1000 : -1000;
+        } else if (childMask == Board::boardMask()) {
+            child.value = 0;
+        } else {
+            child.value = heuristic;
+            child.terminal = false;
+        }
+        
+        // Keep the canonical orientation; mirroring a key mirrors its parts
+        child.key = childX + childMask;
+        child.mask = childMask;
+        Word mirrored = Board::mirror(child.key);
+        if (mirrored < child.key) {
+            child.key = mirrored;
+            child.mask = Board::mirror(childMask);
+        }
+    }
+    return count;
+}
+
+template <class Board>
+int BasicAIPlayer<Board>::bfsEvaluate(const GameState& startState) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    chrono::steady_clock::time_point bfsDeadline = start + bfsTimeBudget;
+    bool timed = bfsTimeBudget.count() > 0;
+    int threads = threadCount;
+    lastStats.reset();
+    
+    int bestScore = fromOwnView(startState.evaluateState());
+    long long nodes = 1;
+    int levels = 0;
+    
+    // The current level lives in bfsLevelArenas[level], the next one is
+    // built in the other arena
+    const Board& root = startState.getBoard();
+    int level = 0;
+    BfsEntry* frontier = bfsLevelArenas[level].allocateArray<BfsEntry>(1);
+    size_t frontierSize = 0;
+    if (!startState.isWinningState() && !startState.isDrawState()) {
+        BfsEntry& entry = frontier[frontierSize++];
+        entry.key = root.canonicalKey();
+        entry.mask = root.isMirroredCanonical() ? Board::mirror(root.getMask()) : root.getMask();
+        entry.value = startState.getHeuristic();
+        entry.terminal = false;
+    }
+    
+    char player = (startState.getLastPlayer() == 'X') ? 'O' : 'X';
+    atomic<bool> outOfTime(false);
+    while (levels < maxDepth && frontierSize > 0 && !outOfTime) {
+        // Expand only if the worst case (every child distinct) fits: the
+        // frontier, the children and their deduplicated copies
+        const size_t CHUNK = 256;
+        size_t chunks = (frontierSize + CHUNK - 1) / CHUNK;
+        size_t worstChildren = frontierSize * Board::WIDTH;
+        if ((frontierSize + 2 * worstChildren) * sizeof(BfsEntry) + chunks * threads * sizeof(size_t) > bfsMemoryBytes) {
+            break;
+        }
+        
+        // Expand chunks of the frontier in parallel. Every chunk writes its
+        // children to its own slice and counts them per owner thread, which
+        // deduplicates the keys it is picked for. slots is indexed
+        // [chunk * threads + owner]
+        BfsEntry* children = bfsScratch.allocateArray<BfsEntry>(worstChildren);
+        size_t* childCounts = bfsScratch.allocateArray<size_t>(chunks);
+        size_t* slots = bfsScratch.allocateArray<size_t>(chunks * threads);
+        atomic<size_t> nextChunk(0);
+        runOnHelpers([&](int) {
+            for (size_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+                size_t* counts = &slots[chunk * threads];
+                fill(counts, counts + threads, 0);
+                childCounts[chunk] = 0;
+                if (timed && !outOfTime && chrono::steady_clock::now() >= bfsDeadline) {
+                    outOfTime = true;
+                }
+                if (outOfTime) {
+                    continue;
+                }
+                
+                BfsEntry* out = children + chunk * CHUNK * Board::WIDTH;
+                size_t count = 0;
+                for (size_t i = chunk * CHUNK; i < min((chunk + 1) * CHUNK, frontierSize); i++) {
+                    count += expandBfsEntry(frontier[i], player, out + count);
+                }
+                for (size_t i = 0; i < count; i++) {
+                    counts[keyOwner(out[i].key, threads)]++;
+                }
+                childCounts[chunk] = count;
+            }
+        });
+        
+        // Turn the counts into the slots of every chunk in the next level,
+        // where the children of each owner follow each other in chunk order
+        size_t* ownerBegin = bfsScratch.allocateArray<size_t>(threads + 1);
+        size_t total = 0;
+        for (int owner = 0; owner < threads; owner++) {
+            ownerBegin[owner] = total;
+            for (size_t chunk = 0; chunk < chunks; chunk++) {
+                size_t count = slots[chunk * threads + owner];
+                slots[chunk * threads + owner] = total;
+                total += count;
+            }
+        }
+        ownerBegin[threads] = total;
+        
+        int next = 1 - level;
+        BfsEntry* nextLevel = bfsLevelArenas[next].allocateArray<BfsEntry>(total);
+        nextChunk = 0;
+        runOnHelpers([&](int) {
+            for (size_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+                const BfsEntry* in = children + chunk * CHUNK * Board::WIDTH;
+                size_t* chunkSlots = &slots[chunk * threads];
+                for (size_t i = 0; i < childCounts[chunk]; i++) {
+                    nextLevel[chunkSlots[keyOwner(in[i].key, threads)]++] = in[i];
+                }
+            }
+        });
+        
+        // Every owner sorts and deduplicates the children with its keys, then
+        // scores them; only one owner ever sees a given position
+        int* ownerBest = bfsScratch.allocateArray<int>(threads);
+        size_t* ownerNodes = bfsScratch.allocateArray<size_t>(threads);
+        size_t* ownerEnd = bfsScratch.allocateArray<size_t>(threads);
+        runOnHelpers([&](int owner) {
+            BfsEntry* begin = nextLevel + ownerBegin[owner];
+            BfsEntry* end = nextLevel + ownerBegin[owner + 1];
+            sort(begin, end, [](const BfsEntry& a, const BfsEntry& b) { return a.key < b.key; });
+            end = unique(begin, end, [](const BfsEntry& a, const BfsEntry& b) { return a.key == b.key; });
+            
+            ownerBest[owner] = INT_MIN;
+            for (const BfsEntry* entry = begin; entry != end; entry++) {
+                ownerBest[owner] = max(ownerBest[owner], fromOwnView(entry->value));
+            }
+            ownerNodes[owner] = static_cast<size_t>(end - begin);
+            ownerEnd[owner] = static_cast<size_t>(remove_if(begin, end, [](const BfsEntry& entry) { return entry.terminal; }) -
+                                                  nextLevel);
+        });
         
-        for (const GameState& nextState : nextStates) {
-            if (visited.find(nextState) == visited.end()) {
-                visited.insert(nextState);
-                bfsQueue.push(nextState);
+        // The surviving children of every owner, moved together, form the
+        // next level
+        frontierSize = 0;
+        for (int owner = 0; owner < threads; owner++) {
+            bestScore = max(bestScore, ownerBest[owner]);
+            nodes += static_cast<long long>(ownerNodes[owner]);
+            if (ownerBegin[owner] != frontierSize) {
+                copy(nextLevel + ownerBegin[owner], nextLevel + ownerEnd[owner], nextLevel + frontierSize);
             }
+            frontierSize += ownerEnd[owner] - ownerBegin[owner];
+        }
+        frontier = nextLevel;
+        bfsLevelArenas[level].reset();
+        bfsScratch.reset();
+        level = next;
+        
+        player = (player == 'X') ? 'O' : 'X';
+        if (!outOfTime) {
+            levels++;
         }
     }
+    bfsLevelArenas[level].reset();
     
+    lastStats.nodes = nodes;
+    lastStats.depth = levels;
+    lastStats.score = bestScore;
+    lastStats.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
     return bestScore;
 }
 
-int AIPlayer::minimax(const GameState& state, int depth, bool isMaximizing, int alpha, int beta) {
+template <class Board>
+int BasicAIPlayer<Board>::minimax(const GameState& state, int depth, bool isMaximizing, int alpha, int beta) {
+    SearchContext ctx;
+    SearchPosition pos(state);
+    return alphaBeta(ctx, pos, depth, isMaximizing, alpha, beta);
+}
+
+template <class Board>
+int BasicAIPlayer<Board>::alphaBeta(SearchContext& ctx, SearchPosition& pos, int depth, bool isMaximizing, int alpha, int beta) {
+    // A game has at most WIDTH * HEIGHT plies, so ply + 1 stays below
+    // MAX_PLY, which fits in nodesPerPly for every board variant
+    ctx.stats.nodes++;
+    ctx.stats.nodesPerPly[ctx.ply + 1]++;
+    
     // Base cases
-    if (depth == 0 || state.isWinningState() || state.isDrawState()) {
-        return state.evaluateState();
+    if (depth == 0 || pos.isWinningState() || pos.isDrawState()) {
+        ctx.stats.evaluations++;
+        return fromOwnView(pos.evaluateState());
     }
     
+    // Out of time: the caller discards the result of this iteration
+    if (shouldStop(ctx)) {
+        return 0;
+    }
+    
+    // Probe the transposition table for a usable bound and a move to try first
+    uint64_t key = positionKey(pos, isMaximizing);
+    int ttMove = -1;
+    TTEntry entry;
+    ctx.stats.tableProbes++;
+    bool tableHit = transpositionTable.probe(key, entry);
+    if (tableHit) {
+        ctx.stats.tableHits++;
+        ttMove = tableMove(pos, entry.bestMove);
+        if (entry.depth >= depth) {
+            int ttScore = fromOwnView(entry.score);
+            BoundType ttBound = tableBound(static_cast<BoundType>(entry.bound));
+            if (ttBound == BOUND_EXACT) {
+                return ttScore;
+            } else if (ttBound == BOUND_LOWER) {
+                alpha = max(alpha, ttScore);
+            } else if (ttBound == BOUND_UPPER) {
+                beta = min(beta, ttScore);
+            }
+            if (alpha >= beta) {
+                return ttScore;
+            }
+        }
+    }
+    
+    int searchAlpha = alpha;
+    int searchBeta = beta;
+    
+    // Apply the threat rules to positions not in the table; a stored
+    // position already went through them. A proven loss scores like the
+    // opponent's win and is stored for every depth. When the player to move
+    // cannot win, the score is at most a draw for that player, which narrows
+    // the window (the result is capped to match below).
+    ThreatVerdict verdict = VERDICT_UNKNOWN;
+    if (!tableHit && threatAnalysis && pos.getBoard().getMoveCount() >= THREAT_ANALYSIS_MIN_MOVES) {
+        char mover = isMaximizing ? playerSymbol : opponentSymbol;
+        verdict = BasicThreatAnalyzer<Board>::analyze(pos.getBoard(), mover);
+        if (verdict == VERDICT_LOSS) {
+            ctx.stats.threatProofs++;
+            int score = fromOwnView(mover == 'X' ? 1000 : -1000);
+            transpositionTable.store(key, MAX_PLY, BOUND_EXACT, fromOwnView(score), -1);
+            return score;
+        }
+        if (verdict == VERDICT_NO_WIN) {
+            if (isMaximizing) {
+                beta = min(beta, 0);
+            } else {
+                alpha = max(alpha, 0);
+            }
+            if (alpha >= beta) {
+                return 0;
+            }
+        }
+    }
+    
+    int bestEval;
+    int bestMove = -1;
+    
+    int moves[Board::WIDTH];
+    int moveCount = orderMoves(ctx, pos, moves, ttMove, isMaximizing);
+    
+    ctx.ply++;
     if (isMaximizing) {
-        int maxEval = INT_MIN;
-        vector<GameState> nextStates = state.generateNextStates('O');
+        bestEval = INT_MIN;
         
-        for (const GameState& nextState : nextStates) {
-            int eval = minimax(nextState, depth - 1, false, alpha, beta);
-            maxEval = max(maxEval, eval);
+        for (int i = 0; i < moveCount; i++) {
+            pos.play(moves[i], playerSymbol);
+            int eval = alphaBeta(ctx, pos, depth - 1, false, alpha, beta);
+            pos.undo();
+            
+            if (eval > bestEval) {
+                bestEval = eval;
+                bestMove = moves[i];
+            }
             alpha = max(alpha, eval);
             
             if (beta <= alpha) {
                 break; // Beta cutoff
             }
         }
-        return maxEval;
     } else {
-        int minEval = INT_MAX;
-        vector<GameState> nextStates = state.generateNextStates('X');
+        bestEval = INT_MAX;
         
-        for (const GameState& nextState : nextStates) {
-            int eval = minimax(nextState, depth - 1, true, alpha, beta);
-            minEval = min(minEval, eval);
+        for (int i = 0; i < moveCount; i++) {
+            pos.play(moves[i], opponentSymbol);
+            int eval = alphaBeta(ctx, pos, depth - 1, true, alpha, beta);
+            pos.undo();
+            
+            if (eval < bestEval) {
+                bestEval = eval;
+                bestMove = moves[i];
+            }
             beta = min(beta, eval);
             
             if (beta <= alpha) {
                 break; // Alpha cutoff
             }
         }
-        return minEval;
     }
+    ctx.ply--;
+    
+    if (beta <= alpha) {
+        ctx.stats.cutoffs++;
+        if (bestMove == moves[0]) {
+            ctx.stats.firstMoveCutoffs++;
+        }
+        recordCutoff(ctx, bestMove, depth, isMaximizing);
+    }
+    
+    if (ctx.interruptible && stopping()) {
+        return 0;
+    }
+    
+    if (verdict == VERDICT_NO_WIN) {
+        bestEval = isMaximizing ? min(bestEval, 0) : max(bestEval, 0);
+    }
+    
+    // Remember the result together with the kind of bound it represents
+    BoundType bound = BOUND_EXACT;
+    if (bestEval <= searchAlpha) {
+        bound = BOUND_UPPER;
+    } else if (bestEval >= searchBeta) {
+        bound = BOUND_LOWER;
+    }
+    transpositionTable.store(key, depth, tableBound(bound), fromOwnView(bestEval), tableMove(pos, bestMove));
+    
+    return bestEval;
 }
 
-vector<int> AIPlayer::getPossibleMoves(const GameState& state) {
+template <class Board>
+int BasicAIPlayer<Board>::orderMoves(SearchContext& ctx, const SearchPosition& pos, int* moves, int ttMove, bool isMaximizing) {
+    int count = 0;
+    for (int col = 0; col < Board::WIDTH; col++) {
+        if (pos.canPlay(col)) {
+            moves[count++] = col;
+        }
+    }
+    
+    if (!moveOrdering) {
+        // Only search the stored best move first
+        for (int i = 1; i < count; i++) {
+            if (moves[i] == ttMove) {
+                rotate(moves, moves + i, moves + i + 1);
+                break;
+            }
+        }
+        return count;
+    }
+    
+    const int* killers = ctx.killers[min(ctx.ply, MAX_PLY - 1)];
+    const int* history = ctx.history[isMaximizing ? 1 : 0];
+    const Board& board = pos.getBoard();
+    Word own = board.stones(isMaximizing ? playerSymbol : opponentSymbol);
+    int keys[Board::WIDTH];
+    
+    // Rank: table move, killers, threats created, history, then centre columns
+    for (int i = 0; i < count; i++) {
+        int col = moves[i];
+        Word move = pos.moveMask(col);
+        Word threats = Board::winningCells(own | move, board.getMask() | move);
+        
+        int key = 0;
+        if (col == ttMove) {
+            key = 300000000;
+        } else if (col == killers[0]) {
+            key = 200000000;
+        } else if (col == killers[1]) {
+            key = 190000000;
+        } else {
+            key = popCount(threats) * 1000000 + min(history[col], 99999) * 10;
+        }
+        keys[i] = key + Board::WIDTH / 2 - centerDistance(col);
+    }
+    
+    // Insertion sort on at most seven children, highest key first
+    for (int i = 1; i < count; i++) {
+        int col = moves[i];
+        int key = keys[i];
+        int j = i;
+        for (; j > 0 && keys[j - 1] < key; j--) {
+            moves[j] = moves[j - 1];
+            keys[j] = keys[j - 1];
+        }
+        moves[j] = col;
+        keys[j] = key;
+    }
+    
+    return count;
+}
+
+template <class Board>
+void BasicAIPlayer<Board>::recordCutoff(SearchContext& ctx, int move, int depth, bool isMaximizing) {
+    if (move < 0) {
+        return;
+    }
+    
+    int* killers = ctx.killers[min(ctx.ply, MAX_PLY - 1)];
+    if (killers[0] != move) {
+        killers[1] = killers[0];
+        killers[0] = move;
+    }
+    ctx.history[isMaximizing ? 1 : 0][move] += depth * depth;
+}
+
+template <class Board>
+vector<int> BasicAIPlayer<Board>::getPossibleMoves(const GameState& state) {
     vector<int> moves;
     
-    for (int col = 0; col < 7; col++) {
+    for (int col = 0; col < Board::WIDTH; col++) {
         if (state.isValidMove(col)) {
             moves.push_back(col);
         }
@@ -124,21 +858,32 @@ vector<int> AIPlayer::getPossibleMoves(const GameState& state) {
     return moves;
 }
 
-int AIPlayer::evaluateMove(const GameState& state, int move) {
-    GameState nextState = state.makeMove(move, playerSymbol);
+template <class Board>
+int BasicAIPlayer<Board>::evaluateMove(const GameState& state, int move) {
+    SearchContext ctx;
+    return searchMove(ctx, state, move, maxDepth);
+}
+
+template <class Board>
+int BasicAIPlayer<Board>::searchMove(SearchContext& ctx, const GameState& state, int move, int depth) {
+    SearchPosition pos(state);
+    if (pos.canPlay(move)) {
+        pos.play(move, playerSymbol);
+    }
     
     // Use minimax to evaluate this move
-    int score = minimax(nextState, maxDepth - 1, false, INT_MIN, INT_MAX);
+    int score = alphaBeta(ctx, pos, depth - 1, false, INT_MIN, INT_MAX);
     
     // Prefer center columns
-    if (move == 3) score += 10;
-    else if (move == 2 || move == 4) score += 5;
-    else if (move == 1 || move == 5) score += 2;
+    static const int centerBonus[3] = { 10, 5, 2 };
+    int distance = centerDistance(move);
+    if (distance < 3) score += centerBonus[distance];
     
     return score;
 }
 
-bool AIPlayer::isWinningMove(const GameState& state, int move) {
+template <class Board>
+bool BasicAIPlayer<Board>::isWinningMove(const GameState& state, int move) {
     if (!state.isValidMove(move)) {
         return false;
     }
@@ -147,12 +892,17 @@ bool AIPlayer::isWinningMove(const GameState& state, int move) {
     return nextState.isWinningState();
 }
 
-bool AIPlayer::isBlockingMove(const GameState& state, int move) {
+template <class Board>
+bool BasicAIPlayer<Board>::isBlockingMove(const GameState& state, int move) {
     if (!state.isValidMove(move)) {
         return false;
     }
     
-    char opponent = (playerSymbol == 'X') ? 'O' : 'X';
-    GameState nextState = state.makeMove(move, opponent);
+    GameState nextState = state.makeMove(move, opponentSymbol);
     return nextState.isWinningState();
 }
+
+template class BasicAIPlayer<Bitboard>;
+template class BasicAIPlayer<Bitboard8x7>;
+template class BasicAIPlayer<Bitboard9x7>;
+template class BasicAIPlayer<Bitboard9x6Connect5>;
@@ -1,62 +1,276 @@
 #ifndef AIPLAYER_H
 #define AIPLAYER_H
 
-#include "Node.h"
-#include <queue>
-#include <unordered_set>
+#include "Engine.h"
+#include "SearchPosition.h"
+#include "ThreatAnalyzer.h"
+#include "TranspositionTable.h"
+#include "OpeningBook.h"
+#include "Arena.h"
+#include "SearchStats.h"
 #include <string>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 using namespace std;
 
-// AI Player class using BFS for move evaluation
-class AIPlayer {
+// AI Player class using BFS for move evaluation, for any board variant
+template <class Board>
+class BasicAIPlayer : public BasicEngine<Board> {
+public:
+    typedef BasicGameState<Board> GameState;
+    typedef BasicSearchPosition<Board> SearchPosition;
+
 private:
+    typedef typename Board::Word Word;
+    
     char playerSymbol;
+    char opponentSymbol;
     int maxDepth;
+    TranspositionTable transpositionTable;
+    int threadCount;
+    bool moveOrdering;
+    bool threatAnalysis;
+    shared_ptr<const OpeningBook> openingBook;
+    
+    // Deadline handling for time-budgeted searches; stopSearch also ends
+    // the helpers and pondering, stopRequested is only set by stop()
+    bool timeLimited;
+    chrono::steady_clock::time_point deadline;
+    atomic<bool> stopSearch;
+    atomic<bool> stopRequested;
     
-    // Hash function for GameState to use in unordered_set
-    struct GameStateHash {
-        size_t operator()(const GameState& state) const {
-            size_t hash = 0;
-            const vector<vector<char>>& board = state.getBoard();
-            
-            for (int row = 0; row < 6; row++) {
-                for (int col = 0; col < 7; col++) {
-                    hash = hash * 31 + static_cast<size_t>(board[row][col]);
+    // Statistics of the last getBestMove call and an optional per-iteration trace
+    SearchStats lastStats;
+    SearchTraceSink* traceSink;
+    
+    static const int MAX_PLY = Board::WIDTH * Board::HEIGHT + 1;
+    static_assert(MAX_PLY <= SearchStats::MAX_PLY, "SearchStats::nodesPerPly is too small for this board");
+    
+    // The threat rules rarely apply while much of the board is empty, so
+    // positions with fewer stones are not analyzed
+    static const int THREAT_ANALYSIS_MIN_MOVES = Board::WIDTH * Board::HEIGHT / 2;
+    
+    // Per-thread search state; all threads share the transposition table
+    struct SearchContext {
+        int threadId;
+        SearchStats stats;
+        bool interruptible;
+        int ply;
+        
+        // Move ordering heuristics: two killer moves per ply and a
+        // history score per side and column, rewarded on cutoffs
+        int killers[MAX_PLY][2];
+        int history[2][Board::WIDTH];
+        
+        SearchContext(int id = 0) : threadId(id), interruptible(true), ply(0) {
+            for (int i = 0; i < MAX_PLY; i++) {
+                killers[i][0] = killers[i][1] = -1;
+            }
+            for (int side = 0; side < 2; side++) {
+                for (int col = 0; col < Board::WIDTH; col++) {
+                    history[side][col] = 0;
                 }
             }
-            return hash;
         }
     };
     
-    // Equality function for GameState
-    struct GameStateEqual {
-        bool operator()(const GameState& a, const GameState& b) const {
-            const vector<vector<char>>& boardA = a.getBoard();
-            const vector<vector<char>>& boardB = b.getBoard();
-            
-            for (int row = 0; row < 6; row++) {
-                for (int col = 0; col < 7; col++) {
-                    if (boardA[row][col] != boardB[row][col]) {
-                        return false;
-                    }
-                }
-            }
-            return true;
-        }
+    // Lazy SMP helper threads searching the same root to fill the shared table.
+    // They are created by the first multi-threaded search and then sleep until
+    // the next one, so later searches do not pay for starting threads. The
+    // breadth-first evaluation runs its levels on them too (jobWork).
+    vector<thread> helpers;
+    vector<SearchContext> helperContexts;
+    mutex helperMutex;
+    condition_variable helperWake;
+    condition_variable helperIdle;
+    unsigned helperJob;
+    int busyHelpers;
+    bool helpersExit;
+    GameState jobState;
+    vector<int> jobRootMoves;
+    int jobDepthLimit;
+    void (*jobWork)(void*, int);   // Set for jobs other than a search
+    void* jobData;
+    
+    // Background search on the opponent's time
+    thread ponderThread;
+    
+    // One position of a breadth-first level, stored in the orientation of
+    // its canonical key (mirror images evaluate the same)
+    struct BfsEntry {
+        Word key;        // Canonical key: the stones of 'X' plus the occupied cells
+        Word mask;       // Occupied cells in the same orientation
+        int value;       // Static evaluation favouring 'O', as evaluateState
+        bool terminal;   // Won or drawn: scored but not expanded
     };
+    
+    // Budgets of the breadth-first evaluation
+    size_t bfsMemoryBytes;
+    chrono::milliseconds bfsTimeBudget;
+    
+    // Memory of the breadth-first evaluation. The levels alternate between
+    // two arenas, so a level is released in O(1) once the next one is built;
+    // the children of a level and their bookkeeping go to a scratch arena
+    // reset after every level. The blocks are kept for the next search.
+    Arena bfsLevelArenas[2];
+    Arena bfsScratch;
+    
+    // Write the children of a level entry to out; returns how many there are
+    int expandBfsEntry(const BfsEntry& entry, char player, BfsEntry* out) const;
+    
+    // Return a move that wins or blocks immediately, or -1 if there is none
+    int findImmediateMove(const GameState& state);
+    
+    // Return the opening book move for a position, or -1 if there is none
+    int findBookMove(const GameState& state) const;
+    
+    // Record a move chosen without searching, scored by the static evaluation
+    int unsearchedMove(const GameState& state, int move);
+    
+    // Legal moves at the root; on a symmetric board the mirror images of
+    // the left half score the same and are left out
+    vector<int> getRootMoves(const GameState& state);
+    
+    // Best line from a root move, following the moves stored in the table
+    vector<int> principalVariation(const GameState& state, int firstMove, int depth);
+    
+    // Statistics of the main thread after a completed iteration, for tracing
+    SearchStats iterationStats(const SearchContext& ctx, const GameState& state, chrono::steady_clock::time_point start,
+                               int depth, int score, int bestMove);
+    
+    // Score a root move with a search of the given depth
+    int searchMove(SearchContext& ctx, const GameState& state, int move, int depth);
+    
+    // Fill moves with the legal columns, those most likely to cause a cutoff first;
+    // returns the number of moves
+    int orderMoves(SearchContext& ctx, const SearchPosition& pos, int* moves, int ttMove, bool isMaximizing);
+    
+    // Reward a move that caused a cutoff
+    void recordCutoff(SearchContext& ctx, int move, int depth, bool isMaximizing);
+    
+    // Alpha-beta search used by every thread
+    int alphaBeta(SearchContext& ctx, SearchPosition& pos, int depth, bool isMaximizing, int alpha, int beta);
+    
+    // Create the helper threads, or replace them if the thread count changed
+    void ensureHelpers();
+    
+    // Start and stop the helper threads of a multi-threaded search
+    void startHelpers(const GameState& state, const vector<int>& rootMoves, int depthLimit);
+    void stopHelpers(const SearchContext& mainContext);
+    void runHelper(SearchContext& ctx, GameState state, vector<int> rootMoves, int depthLimit);
+    
+    // Run work(index) for index 0..threadCount-1, on the calling thread and
+    // the helpers, and wait until all are done
+    template <class Work>
+    void runOnHelpers(Work work) {
+        runOnHelpers([](void* data, int index) { (*static_cast<Work*>(data))(index); }, &work);
+    }
+    void runOnHelpers(void (*work)(void*, int), void* data);
+    
+    // Body of a helper thread: wait for a job, run it, repeat
+    void helperLoop(int index, unsigned job);
+    
+    // Terminate the helper threads
+    void shutdownHelpers();
+    
+    // Body of the pondering thread
+    void ponder(GameState state);
+    
+    // Check the clock every 1024 nodes and raise the stop flag
+    bool shouldStop(SearchContext& ctx) {
+        if (!ctx.interruptible) {
+            return false;
+        }
+        if (timeLimited && (ctx.stats.nodes & 1023) == 0 && chrono::steady_clock::now() >= deadline) {
+            stopSearch = true;
+        }
+        return stopping();
+    }
+    
+    bool stopping() const { return stopSearch || stopRequested; }
+    
+    // Evaluations favour 'O'; flip them when this player is 'X'
+    int fromOwnView(int score) const {
+        return playerSymbol == 'X' ? -score : score;
+    }
+    
+    // Zobrist key of a position including the side to move. Mirror images
+    // share a key, so the table holds every position only once
+    uint64_t positionKey(const SearchPosition& pos, bool isMaximizing) const {
+        char mover = isMaximizing ? playerSymbol : opponentSymbol;
+        return pos.getBoard().getCanonicalHash() ^ (mover == 'O' ? Board::zobrist.side : 0);
+    }
+    
+    // The table holds scores from the view of 'O', like evaluateState, so its
+    // entries stay valid when the player changes sides. Scores convert with
+    // fromOwnView and bounds with tableBound (both are their own inverse).
+    BoundType tableBound(BoundType bound) const {
+        if (playerSymbol == 'X' && bound != BOUND_EXACT) {
+            return bound == BOUND_LOWER ? BOUND_UPPER : BOUND_LOWER;
+        }
+        return bound;
+    }
+    
+    // Convert a table move between the position and the orientation its key
+    // was taken from (mirroring is its own inverse)
+    static int tableMove(const SearchPosition& pos, int move) {
+        return (move >= 0 && pos.getBoard().isMirroredHash()) ? Board::WIDTH - 1 - move : move;
+    }
+    
+    // Columns between a column and the centre (the two middle columns of an
+    // even board both count as centre)
+    static int centerDistance(int col) {
+        return abs(2 * col - (Board::WIDTH - 1)) / 2;
+    }
+    
+    // Thread that deduplicates a canonical key in the breadth-first evaluation
+    static int keyOwner(Word key, int owners) {
+        return static_cast<int>(static_cast<size_t>(key ^ (key >> 29)) % static_cast<size_t>(owners));
+    }
 
 public:
     // Constructor
-    AIPlayer(char symbol, int depth = 4) : playerSymbol(symbol), maxDepth(depth) {}
+    BasicAIPlayer(char symbol, int depth = 4, size_t ttSizeMB = 16, int threads = 1)
+        : playerSymbol(symbol), opponentSymbol(symbol == 'X' ? 'O' : 'X'), maxDepth(depth), transpositionTable(ttSizeMB), threadCount(max(threads, 1)),
+          moveOrdering(true), threatAnalysis(true), timeLimited(false), stopSearch(false), stopRequested(false), traceSink(nullptr),
+          helperJob(0), busyHelpers(0), helpersExit(false), jobDepthLimit(0), jobWork(nullptr), jobData(nullptr),
+          bfsMemoryBytes(64 * 1024 * 1024), bfsTimeBudget(0) {}
+    
+    // Destructor
+    ~BasicAIPlayer() {
+        stopPondering();
+        shutdownHelpers();
+    }
     
     // Get the best move using BFS with evaluation
-    int getBestMove(const GameState& currentState);
+    int getBestMove(const GameState& currentState) override;
+    
+    // Get the best move found by iterative deepening within a time budget;
+    // returns the result of the deepest iteration that completed in time
+    int getBestMove(const GameState& currentState, chrono::milliseconds timeBudget) override;
     
-    // BFS search to evaluate all possible moves
+    // The same, deepening at most to depthLimit plies
+    int getBestMove(const GameState& currentState, chrono::milliseconds timeBudget, int depthLimit);
+    
+    // Best static evaluation among the positions up to maxDepth plies below
+    // a state, explored level by level on all search threads. A level is
+    // only expanded if its worst case fits in the memory budget; when the
+    // time budget runs out the current level is cut short.
     int bfsEvaluate(const GameState& startState);
     
-    // Minimax algorithm with alpha-beta pruning
+    // Budgets of bfsEvaluate; a zero time budget means no time limit
+    void setBfsBudget(size_t memoryMB, chrono::milliseconds timeBudget) {
+        bfsMemoryBytes = max<size_t>(memoryMB, 1) * 1024 * 1024;
+        bfsTimeBudget = timeBudget;
+    }
+    
+    // Minimax algorithm with alpha-beta pruning and a transposition table
     int minimax(const GameState& state, int depth, bool isMaximizing, int alpha, int beta);
     
     // Get all possible moves for current state
@@ -70,6 +284,67 @@ public:
     
     // Check if a move blocks opponent's winning move
     bool isBlockingMove(const GameState& state, int move);
+    
+    // Play the other side from the next search on; the transposition table
+    // does not depend on the side and is kept (no search may be running)
+    void setSymbol(char symbol) {
+        playerSymbol = symbol;
+        opponentSymbol = (symbol == 'X') ? 'O' : 'X';
+    }
+    char getSymbol() const { return playerSymbol; }
+    
+    // Transposition table control
+    void setHashSize(size_t sizeMB) { transpositionTable.resize(sizeMB); }
+    void clearHash() { transpositionTable.clear(); }
+    void newGame() override { clearHash(); }
+    
+    // Interrupt the running search from another thread. A time-budgeted
+    // search returns the best move of its last completed iteration, a
+    // fixed-depth one the best root move it searched completely. The request
+    // also ends searches started later, until clearStop() is called.
+    void stop() override { stopRequested = true; }
+    void clearStop() override { stopRequested = false; }
+    
+    // Search the replies to the opponent's possible moves in the background
+    // while the opponent (to move in state) thinks; the results stay in the
+    // transposition table for the next getBestMove. No other search may run
+    // until stopPondering() is called.
+    void startPondering(const GameState& state) override;
+    void stopPondering() override;
+    bool isPondering() const { return ponderThread.joinable(); }
+    
+    // Depth of the fixed-depth search
+    void setDepth(int depth) { maxDepth = max(depth, 1); }
+    
+    // Number of search threads (1 keeps the search deterministic)
+    void setThreads(int threads) override { threadCount = max(threads, 1); }
+    int getThreads() const { return threadCount; }
+    
+    // Enable or disable move ordering beyond the transposition table move
+    void setMoveOrdering(bool enabled) { moveOrdering = enabled; }
+    
+    // Enable or disable the odd/even threat rules in the search: positions
+    // they prove lost end the search, and positions where the player to move
+    // cannot win are bounded by a draw
+    void setThreatAnalysis(bool enabled) { threatAnalysis = enabled; }
+    
+    // Opening book consulted before searching (may be shared between players);
+    // books only exist for the standard board and are ignored on other variants
+    void setOpeningBook(shared_ptr<const OpeningBook> book) override { openingBook = book; }
+    
+    // Statistics of the last getBestMove call
+    const SearchStats& getLastStats() const override { return lastStats; }
+    long long getLastNodeCount() const { return lastStats.nodes; }
+    long long getLastTableProbes() const { return lastStats.tableProbes; }
+    long long getLastTableHits() const { return lastStats.tableHits; }
+    int getLastScore() const { return lastStats.score; }
+    int getLastDepth() const { return lastStats.depth; }
+    
+    // Receive statistics after every iteration; only used when the build
+    // defines SEARCH_TRACE (the sink must outlive the searches)
+    void setTraceSink(SearchTraceSink* sink) { traceSink = sink; }
 };
 
+typedef BasicAIPlayer<Bitboard> AIPlayer;
+
 #endif
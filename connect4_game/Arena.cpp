@@ -0,0 +1,33 @@
+#include "Arena.h"
+#include <algorithm>
+
+Arena::Arena(size_t blockBytes) : blockSize(blockBytes), current(0), used(0), blockAllocations(0) {}
+
+void* Arena::allocateSlow(size_t bytes, size_t alignment) {
+    // Skip to a kept block with enough room; the start of a block is
+    // aligned for any type
+    size_t next = blocks.empty() ? 0 : current + 1;
+    while (next < blocks.size() && blocks[next].size < bytes) {
+        next++;
+    }
+    
+    if (next == blocks.size()) {
+        Block block;
+        block.size = max(blockSize, bytes + alignment);
+        block.data.reset(new char[block.size]);
+        blocks.push_back(move(block));
+        blockAllocations++;
+    }
+    
+    current = next;
+    used = bytes;
+    return blocks[current].data.get();
+}
+
+size_t Arena::capacity() const {
+    size_t total = 0;
+    for (const Block& block : blocks) {
+        total += block.size;
+    }
+    return total;
+}
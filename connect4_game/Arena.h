@@ -0,0 +1,68 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Bump allocator for data that lives exactly as long as one search.
+// Allocation moves a pointer through large blocks; nothing is freed on its
+// own. reset() releases everything at once by rewinding to the first block
+// and keeps the blocks, so a search that fits in what earlier searches used
+// does not touch the heap at all. Objects placed in an arena must not need
+// their destructors to run after a reset.
+class Arena {
+private:
+    struct Block {
+        unique_ptr<char[]> data;
+        size_t size;
+    };
+    
+    vector<Block> blocks;
+    size_t blockSize;
+    size_t current;      // Block being filled
+    size_t used;         // Bytes used in the current block
+    size_t blockAllocations;
+    
+    // Continue in the next block that fits, creating one if needed
+    void* allocateSlow(size_t bytes, size_t alignment);
+    
+    // An arena owns its blocks
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+public:
+    // Constructor
+    explicit Arena(size_t blockBytes = 64 * 1024);
+    
+    // Memory for bytes with the given alignment (a power of two, at most
+    // alignof(max_align_t))
+    void* allocate(size_t bytes, size_t alignment) {
+        size_t offset = (used + alignment - 1) & ~(alignment - 1);
+        if (current < blocks.size() && offset + bytes <= blocks[current].size) {
+            used = offset + bytes;
+            return blocks[current].data.get() + offset;
+        }
+        return allocateSlow(bytes, alignment);
+    }
+    
+    // Uninitialized array of count objects of a trivially copyable type
+    template <class T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+    
+    // Release every allocation in O(1), keeping the blocks for reuse
+    void reset() {
+        current = 0;
+        used = 0;
+    }
+    
+    // Statistics: bytes reserved in blocks and blocks taken from the heap so far
+    size_t capacity() const;
+    size_t getBlockAllocations() const { return blockAllocations; }
+};
+
+#endif
@@ -0,0 +1,210 @@
+#include "BatchAnalyzer.h"
+#include "AIPlayer.h"
+#include "Solver.h"
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Quote a CSV field when it contains separators or quotes
+string csvField(const string& text) {
+    if (text.find_first_of(",\"\n") == string::npos) {
+        return text;
+    }
+    string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Escape a string for a JSON value
+string jsonString(const string& text) {
+    ostringstream out;
+    out << '"';
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (c < 0x20) {
+            out << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(c) << dec;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+}
+
+BatchAnalyzer::BatchAnalyzer(const AnalysisOptions& opts)
+    : options(opts), input(nullptr), output(nullptr), linesRead(0), errors(0) {
+    if (options.threads < 1) {
+        options.threads = 1;
+    }
+}
+
+bool BatchAnalyzer::parseMoves(const string& moves, GameState& state) {
+    state = GameState();
+    if (moves == "0") {
+        return true;
+    }
+    
+    char player = 'X';
+    for (char c : moves) {
+        int col = c - '1';
+        if (col < 0 || col >= Bitboard::WIDTH || !state.isValidMove(col) || state.isWinningState()) {
+            return false;
+        }
+        state = state.makeMove(col, player);
+        player = (player == 'X') ? 'O' : 'X';
+    }
+    return true;
+}
+
+bool BatchAnalyzer::nextLine(string& line, long long& lineNumber) {
+    lock_guard<mutex> lock(inputMutex);
+    while (getline(*input, line)) {
+        lineNumber = ++linesRead;
+        
+        // Tolerate Windows line endings and surrounding blanks
+        size_t first = line.find_first_not_of(" \t\r");
+        size_t last = line.find_last_not_of(" \t\r");
+        line = (first == string::npos) ? string() : line.substr(first, last - first + 1);
+        
+        if (!line.empty() && line[0] != '#') {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BatchAnalyzer::writeResult(const AnalysisResult& result) {
+    ostringstream record;
+    bool ok = result.error.empty();
+    
+    if (options.jsonl) {
+        record << "{\"line\":" << result.line << ",\"moves\":" << jsonString(result.moves);
+        if (ok) {
+            record << ",\"side\":\"" << result.side << "\",\"best_move\":" << result.bestMove + 1
+                   << ",\"score\":" << result.score << ",\"depth\":" << result.depth
+                   << ",\"nodes\":" << result.nodes << ",\"time_ms\":"
+                   << fixed << setprecision(3) << result.timeMs;
+        } else {
+            record << ",\"error\":" << jsonString(result.error);
+        }
+        record << "}\n";
+    } else {
+        record << result.line << "," << csvField(result.moves) << ",";
+        if (ok) {
+            record << result.side << "," << result.bestMove + 1 << "," << result.score << ","
+                   << result.depth << "," << result.nodes << "," << fixed << setprecision(3) << result.timeMs;
+        } else {
+            record << ",,,,,";
+        }
+        record << "," << csvField(result.error) << "\n";
+    }
+    
+    lock_guard<mutex> lock(outputMutex);
+    *output << record.str();
+    if (!ok) {
+        errors++;
+    }
+}
+
+void BatchAnalyzer::runWorker() {
+    // Engines are reused for every position this worker analyzes
+    unique_ptr<Solver> solver;
+    unique_ptr<AIPlayer> players[2];
+    if (options.solve) {
+        solver = unique_ptr<Solver>(new Solver(options.hashMB));
+    } else {
+        players[0] = unique_ptr<AIPlayer>(new AIPlayer('X', options.depth, options.hashMB));
+        players[1] = unique_ptr<AIPlayer>(new AIPlayer('O', options.depth, options.hashMB));
+    }
+    
+    StreamTraceSink trace(cerr);
+    if (options.trace && !options.solve) {
+        players[0]->setTraceSink(&trace);
+        players[1]->setTraceSink(&trace);
+    }
+    
+    string line;
+    long long lineNumber = 0;
+    while (nextLine(line, lineNumber)) {
+        AnalysisResult result;
+        result.line = lineNumber;
+        result.moves = line;
+        result.side = ' ';
+        result.bestMove = -1;
+        result.score = 0;
+        result.depth = 0;
+        result.nodes = 0;
+        result.timeMs = 0.0;
+        
+        GameState state;
+        if (!parseMoves(line, state)) {
+            result.error = "invalid move sequence";
+            writeResult(result);
+            continue;
+        }
+        if (state.isWinningState() || state.isDrawState()) {
+            result.error = "game over";
+            writeResult(result);
+            continue;
+        }
+        
+        result.side = Solver::sideToMove(state);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        
+        if (solver) {
+            // An empty table for every position, as for the search below
+            solver->reset();
+            result.bestMove = solver->bestMove(state, &result.score);
+            result.depth = Bitboard::WIDTH * Bitboard::HEIGHT - state.getBoard().getMoveCount();
+            result.nodes = solver->getNodeCount();
+        } else {
+            // Start from an empty table so results do not depend on which
+            // positions this worker happened to analyze before
+            AIPlayer& ai = *players[result.side == 'X' ? 0 : 1];
+            ai.clearHash();
+            if (options.moveTimeMs > 0) {
+                result.bestMove = ai.getBestMove(state, chrono::milliseconds(options.moveTimeMs));
+            } else {
+                result.bestMove = ai.getBestMove(state);
+            }
+            result.score = ai.getLastScore();
+            result.depth = ai.getLastDepth();
+            result.nodes = ai.getLastNodeCount();
+        }
+        
+        result.timeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        writeResult(result);
+    }
+}
+
+long long BatchAnalyzer::run(istream& in, ostream& out) {
+    input = &in;
+    output = &out;
+    linesRead = 0;
+    errors = 0;
+    
+    if (!options.jsonl) {
+        out << "line,moves,side,best_move,score,depth,nodes,time_ms,error\n";
+    }
+    
+    vector<thread> workers;
+    for (int i = 1; i < options.threads; i++) {
+        workers.push_back(thread(&BatchAnalyzer::runWorker, this));
+    }
+    runWorker();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    
+    out.flush();
+    return errors;
+}
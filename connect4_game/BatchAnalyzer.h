@@ -0,0 +1,77 @@
+#ifndef BATCHANALYZER_H
+#define BATCHANALYZER_H
+
+#include "Node.h"
+#include <iostream>
+#include <string>
+#include <mutex>
+
+using namespace std;
+
+// Settings of a batch analysis run
+struct AnalysisOptions {
+    int depth;          // Fixed search depth
+    int moveTimeMs;     // Time budget per position; 0 searches to the fixed depth
+    bool solve;         // Use the perfect-play solver instead of the search
+    int threads;        // Positions analyzed in parallel
+    size_t hashMB;      // Table size per worker
+    bool jsonl;         // JSON lines instead of CSV
+    bool trace;         // Log every search iteration to stderr (SEARCH_TRACE builds)
+    
+    AnalysisOptions() : depth(8), moveTimeMs(0), solve(false), threads(1), hashMB(4), jsonl(false), trace(false) {}
+};
+
+// Result of analyzing one input line
+struct AnalysisResult {
+    long long line;
+    string moves;
+    char side;
+    int bestMove;       // Column 0-6, -1 on error
+    int score;          // From the view of the player to move
+    int depth;
+    long long nodes;
+    double timeMs;
+    string error;
+};
+
+// Non-interactive analysis of positions given as move strings (columns 1-7,
+// X moves first), one per line. Empty lines and lines starting with '#' are
+// skipped and "0" stands for the empty board.
+//
+// Worker threads take lines from the input as they become free and write each
+// result as soon as it is ready, so any number of positions can be streamed
+// with constant memory. With several threads the output is not in input
+// order; every record carries its line number.
+class BatchAnalyzer {
+private:
+    AnalysisOptions options;
+    istream* input;
+    ostream* output;
+    long long linesRead;
+    long long errors;
+    mutex inputMutex;
+    mutex outputMutex;
+    
+    // Take the next position line, returns false at the end of the input
+    bool nextLine(string& line, long long& lineNumber);
+    
+    // Write one result in the selected format
+    void writeResult(const AnalysisResult& result);
+    
+    // Analysis loop of one worker thread
+    void runWorker();
+
+public:
+    // Constructor
+    explicit BatchAnalyzer(const AnalysisOptions& opts);
+    
+    // Analyze every position of the input; returns the number of lines that
+    // could not be analyzed
+    long long run(istream& in, ostream& out);
+    
+    // Replay a move string from the empty board; returns false if it is not
+    // a legal move sequence
+    static bool parseMoves(const string& moves, GameState& state);
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "Bitboard.h"
+
+namespace {
+
+// SplitMix64 generator with a fixed seed, so hashes are reproducible across runs
+uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+// Builds the window table once, enumerating windows in the same order as the
+// original row/column scans so evaluation sums stay comparable.
+template <class Board>
+struct WindowTable {
+    typedef typename Board::Word Word;
+    static const int SPAN = Board::CONNECT - 1;
+    
+    Word masks[Board::NUM_WINDOWS];
+    
+    WindowTable() {
+        int n = 0;
+        
+        // Horizontal windows
+        for (int row = 0; row < Board::HEIGHT; row++) {
+            for (int col = 0; col + SPAN < Board::WIDTH; col++) {
+                masks[n++] = window(row, col, 0, 1);
+            }
+        }
+        
+        // Vertical windows
+        for (int col = 0; col < Board::WIDTH; col++) {
+            for (int row = 0; row + SPAN < Board::HEIGHT; row++) {
+                masks[n++] = window(row, col, 1, 0);
+            }
+        }
+        
+        // Diagonal windows (top-left to bottom-right)
+        for (int row = 0; row + SPAN < Board::HEIGHT; row++) {
+            for (int col = 0; col + SPAN < Board::WIDTH; col++) {
+                masks[n++] = window(row, col, 1, 1);
+            }
+        }
+        
+        // Diagonal windows (top-right to bottom-left)
+        for (int row = 0; row + SPAN < Board::HEIGHT; row++) {
+            for (int col = SPAN; col < Board::WIDTH; col++) {
+                masks[n++] = window(row, col, 1, -1);
+            }
+        }
+    }
+    
+    static Word window(int row, int col, int dRow, int dCol) {
+        Word m = 0;
+        for (int i = 0; i < Board::CONNECT; i++) {
+            m |= Board::cellMask(row + i * dRow, col + i * dCol);
+        }
+        return m;
+    }
+};
+
+}
+
+template <int W, int H, int N>
+const typename BasicBitboard<W, H, N>::ZobristKeys BasicBitboard<W, H, N>::zobrist;
+
+template <int W, int H, int N>
+BasicBitboard<W, H, N>::ZobristKeys::ZobristKeys() {
+    uint64_t state = UINT64_C(0xC0FFEE4C0441);
+    for (int p = 0; p < 2; p++) {
+        for (int bit = 0; bit < WORD_BITS; bit++) {
+            pieces[p][bit] = splitMix64(state);
+        }
+    }
+    side = splitMix64(state);
+}
+
+template <int W, int H, int N>
+uint64_t BasicBitboard<W, H, N>::computeHash(Word x, Word m) {
+    uint64_t h = 0;
+    for (Word rest = m; rest; rest &= rest - 1) {
+        int bit = lowestBit(rest);
+        h ^= zobrist.pieces[(x >> bit) & 1 ? 0 : 1][bit];
+    }
+    return h;
+}
+
+template <int W, int H, int N>
+const typename BasicBitboard<W, H, N>::Word* BasicBitboard<W, H, N>::windowMasks() {
+    static const WindowTable<BasicBitboard> table;
+    return table.masks;
+}
+
+template class BasicBitboard<7, 6, 4>;
+template class BasicBitboard<8, 7, 4>;
+template class BasicBitboard<9, 7, 4>;
+template class BasicBitboard<9, 6, 5>;
@@ -0,0 +1,286 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+
+using namespace std;
+
+// Storage for the bits of a board: a 64-bit word when the board fits,
+// otherwise a 128-bit one
+template <bool WIDE>
+struct BoardWord {
+    typedef uint64_t type;
+};
+
+template <>
+struct BoardWord<true> {
+    typedef unsigned __int128 type;
+};
+
+// Bit counting for both word sizes
+inline int popCount(uint64_t bits) { return __builtin_popcountll(bits); }
+inline int lowestBit(uint64_t bits) { return __builtin_ctzll(bits); }
+
+inline int popCount(unsigned __int128 bits) {
+    return __builtin_popcountll(static_cast<uint64_t>(bits)) + __builtin_popcountll(static_cast<uint64_t>(bits >> 64));
+}
+inline int lowestBit(unsigned __int128 bits) {
+    uint64_t low = static_cast<uint64_t>(bits);
+    return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<uint64_t>(bits >> 64));
+}
+
+// Bitboard representation of a Connect 4 board with W columns, H rows and
+// N stones in a row needed to win; the dimensions are compile-time constants
+// so every variant gets its own code with all shifts and masks folded.
+// Each column uses H + 1 bits (H playable cells plus one sentinel bit on top),
+// so cell (height h, column c) lives at bit c * (H + 1) + h, with h = 0 at the bottom.
+// Two masks describe a position: the stones of player 'X' and every occupied cell.
+// A Zobrist hash of the position is kept up to date incrementally by play/unplay,
+// together with the hash of its mirror image so mirrored positions can share
+// cache entries.
+template <int W, int H, int N>
+class BasicBitboard {
+public:
+    static const int WIDTH = W;
+    static const int HEIGHT = H;
+    static const int CONNECT = N;
+    static const int COLUMN_BITS = HEIGHT + 1;
+    static const int NUM_WINDOWS = HEIGHT * (WIDTH - CONNECT + 1) + WIDTH * (HEIGHT - CONNECT + 1) +
+                                   2 * (WIDTH - CONNECT + 1) * (HEIGHT - CONNECT + 1);
+    
+    typedef typename BoardWord<(WIDTH * COLUMN_BITS > 64)>::type Word;
+    static const int WORD_BITS = sizeof(Word) * 8;
+    
+    // Random keys per player and bit, plus a side-to-move key
+    struct ZobristKeys {
+        uint64_t pieces[2][WORD_BITS];
+        uint64_t side;
+        ZobristKeys();
+    };
+    static const ZobristKeys zobrist;
+
+private:
+    Word xStones;
+    Word mask;
+    uint64_t hash;
+    uint64_t mirrorHash;
+    int moves;
+    
+    static int playerIndex(char player) { return player == 'X' ? 0 : 1; }
+    
+    // Bit of the cell in the same row of the mirrored column
+    static int mirrorBit(int bit) {
+        return bit + (WIDTH - 1 - 2 * (bit / COLUMN_BITS)) * COLUMN_BITS;
+    }
+    
+    // Add or remove a stone in both hashes
+    void toggle(int index, int bit) {
+        hash ^= zobrist.pieces[index][bit];
+        mirrorHash ^= zobrist.pieces[index][mirrorBit(bit)];
+    }
+    
+    // A column pattern repeated in every column from col on
+    static constexpr Word everyColumn(Word column, int col) {
+        return col == WIDTH ? Word(0) : (column << (col * COLUMN_BITS)) | everyColumn(column, col + 1);
+    }
+    
+    // Stones with a run of CONNECT stones starting there, in the direction of a shift
+    static Word runs(Word pos, int shift) {
+        // Double the run length while it fits, then extend it to CONNECT
+        Word m = pos;
+        int length = 1;
+        while (length * 2 <= CONNECT) {
+            m &= m >> (length * shift);
+            length *= 2;
+        }
+        if (length < CONNECT) {
+            m &= m >> ((CONNECT - length) * shift);
+        }
+        return m;
+    }
+    
+    // Cells that complete CONNECT in a row along one direction: i stones in
+    // a row on one side of the cell and CONNECT - 1 - i on the other
+    static Word gapCells(Word pos, int shift) {
+        if (CONNECT == 4) {
+            // Standard length: the two gaps on each side share a pair of shifts
+            Word p = (pos << shift) & (pos << 2 * shift);
+            Word r = (p & (pos << 3 * shift)) | (p & (pos >> shift));
+            p = (pos >> shift) & (pos >> 2 * shift);
+            return r | (p & (pos << shift)) | (p & (pos >> 3 * shift));
+        }
+        
+        Word r = 0;
+        for (int i = 0; i < CONNECT; i++) {
+            Word w = ~Word(0);
+            for (int k = 1; k <= i; k++) {
+                w &= pos << (k * shift);
+            }
+            for (int k = 1; k < CONNECT - i; k++) {
+                w &= pos >> (k * shift);
+            }
+            r |= w;
+        }
+        return r;
+    }
+
+public:
+    // Constructor
+    BasicBitboard() : xStones(0), mask(0), hash(0), mirrorHash(0), moves(0) {}
+    BasicBitboard(Word x, Word m, int n)
+        : xStones(x), mask(m), hash(computeHash(x, m)), mirrorHash(computeHash(mirror(x), mirror(m))), moves(n) {}
+    
+    // Getters
+    Word getXStones() const { return xStones; }
+    Word getOStones() const { return xStones ^ mask; }
+    Word getMask() const { return mask; }
+    uint64_t getHash() const { return hash; }
+    
+    // Hash shared by a position and its mirror image, and whether it is
+    // the hash of the mirrored orientation
+    uint64_t getCanonicalHash() const { return mirrorHash < hash ? mirrorHash : hash; }
+    bool isMirroredHash() const { return mirrorHash < hash; }
+    int getMoveCount() const { return moves; }
+    
+    // Stones owned by the given player symbol
+    Word stones(char player) const {
+        return player == 'X' ? xStones : xStones ^ mask;
+    }
+    
+    // Check if a piece can still be dropped into a column
+    bool canPlay(int col) const {
+        return (mask & topMask(col)) == 0;
+    }
+    
+    // Drop a piece into a column and return the bit it landed on
+    Word play(int col, char player) {
+        Word move = (mask + bottomMask(col)) & columnMask(col);
+        mask |= move;
+        if (player == 'X') {
+            xStones |= move;
+        }
+        toggle(playerIndex(player), lowestBit(move));
+        moves++;
+        return move;
+    }
+    
+    // Remove the top piece of a column
+    void unplay(int col) {
+        Word move = (mask + bottomMask(col)) & columnMask(col);
+        Word top = move ? move >> 1 : topMask(col);
+        toggle((xStones & top) ? 0 : 1, lowestBit(top));
+        mask &= ~top;
+        xStones &= ~top;
+        moves--;
+    }
+    
+    // Number of pieces already in a column
+    int columnHeight(int col) const {
+        return popCount(mask & columnMask(col));
+    }
+    
+    // Symbol at a cell, with row 0 at the top as in the display
+    char cellAt(int row, int col) const {
+        Word bit = cellMask(row, col);
+        if (!(mask & bit)) return ' ';
+        return (xStones & bit) ? 'X' : 'O';
+    }
+    
+    bool isFull() const { return moves == WIDTH * HEIGHT; }
+    
+    // Unique key of the position (every column encodes its height and owners)
+    Word key() const { return xStones + mask; }
+    
+    // Key shared by a position and its left-right mirror image
+    Word canonicalKey() const {
+        Word k = key();
+        Word m = mirror(k);
+        return m < k ? m : k;
+    }
+    
+    // Check if canonicalKey() refers to the mirrored orientation
+    bool isMirroredCanonical() const { return mirror(key()) < key(); }
+    
+    // Check if the position equals its own mirror image
+    bool isSymmetric() const { return mirror(key()) == key(); }
+    
+    bool operator==(const BasicBitboard& other) const {
+        return xStones == other.xStones && mask == other.mask;
+    }
+    bool operator!=(const BasicBitboard& other) const { return !(*this == other); }
+    
+    // Reflect a bitboard left to right, column c becoming column WIDTH - 1 - c.
+    // The loop has a constant trip count and unrolls into plain shifts
+    static Word mirror(Word bits) {
+        const Word column = (Word(1) << COLUMN_BITS) - 1;
+        Word m = (WIDTH % 2) ? bits & (column << (WIDTH / 2 * COLUMN_BITS)) : Word(0);
+        for (int col = 0; col < WIDTH / 2; col++) {
+            int shift = (WIDTH - 1 - 2 * col) * COLUMN_BITS;
+            m |= (bits & (column << (col * COLUMN_BITS))) << shift;
+            m |= (bits >> shift) & (column << (col * COLUMN_BITS));
+        }
+        return m;
+    }
+    
+    // Mask helpers
+    static Word bottomMask(int col) { return Word(1) << (col * COLUMN_BITS); }
+    static Word topMask(int col) { return Word(1) << (HEIGHT - 1 + col * COLUMN_BITS); }
+    static Word columnMask(int col) { return ((Word(1) << HEIGHT) - 1) << (col * COLUMN_BITS); }
+    static Word cellMask(int row, int col) {
+        return Word(1) << (col * COLUMN_BITS + (HEIGHT - 1 - row));
+    }
+    static int rowOf(Word bit) {
+        return HEIGHT - 1 - lowestBit(bit) % COLUMN_BITS;
+    }
+    
+    // CONNECT-in-a-row detection with shift-and-AND, one direction at a time
+    static bool alignedHorizontal(Word pos) {
+        return runs(pos, COLUMN_BITS) != 0;
+    }
+    static bool alignedVertical(Word pos) {
+        return runs(pos, 1) != 0;
+    }
+    static bool alignedDiagonal(Word pos) {
+        return runs(pos, COLUMN_BITS - 1) != 0 || runs(pos, COLUMN_BITS + 1) != 0;
+    }
+    static bool hasAlignment(Word pos) {
+        return alignedHorizontal(pos) || alignedVertical(pos) || alignedDiagonal(pos);
+    }
+    
+    // Cells of the whole board and of the bottom row
+    static constexpr Word bottomRow() { return everyColumn(1, 0); }
+    static constexpr Word boardMask() { return everyColumn((Word(1) << HEIGHT) - 1, 0); }
+    
+    // Cells where a piece can be dropped next, one per non-full column
+    static Word playableCells(Word occupied) {
+        return (occupied + bottomRow()) & boardMask();
+    }
+    
+    // Empty cells that would complete CONNECT-in-a-row for the given stones
+    static Word winningCells(Word pos, Word occupied) {
+        // Vertical: CONNECT - 1 stacked stones
+        Word r = pos << 1;
+        for (int k = 2; k < CONNECT; k++) {
+            r &= pos << k;
+        }
+        
+        // Horizontal and both diagonals
+        r |= gapCells(pos, COLUMN_BITS) | gapCells(pos, COLUMN_BITS - 1) | gapCells(pos, COLUMN_BITS + 1);
+        return r & (boardMask() ^ occupied);
+    }
+    
+    // Zobrist hash of an arbitrary position, computed from scratch
+    static uint64_t computeHash(Word x, Word m);
+    
+    // The CONNECT-cell windows of the board, in horizontal, vertical,
+    // diagonal (down-right) and diagonal (down-left) order
+    static const Word* windowMasks();
+};
+
+// The standard 7x6 board and the variants built alongside it
+typedef BasicBitboard<7, 6, 4> Bitboard;
+typedef BasicBitboard<8, 7, 4> Bitboard8x7;
+typedef BasicBitboard<9, 7, 4> Bitboard9x7;
+typedef BasicBitboard<9, 6, 5> Bitboard9x6Connect5;
+
+#endif
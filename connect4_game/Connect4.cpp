@@ -5,14 +5,12 @@
 #include <memory>
 
 Connect4::Connect4(bool enableAI) : currentPlayer('X'), gameOver(false), winner(' '), 
-    currentState(vector<vector<char>>(ROWS, vector<char>(COLS, ' '))), aiEnabled(enableAI) {
-    
-    // Initialize the board with empty spaces
-    board.resize(ROWS, vector<char>(COLS, ' '));
+    lastMoveRow(-1), lastMoveCol(-1), aiEnabled(enableAI), ponderingEnabled(true), aiEngine(ENGINE_MINIMAX),
+    aiDifficulty(4) {
     
     // Initialize AI player if enabled
     if (aiEnabled) {
-        aiPlayer = unique_ptr<AIPlayer>(new AIPlayer('O', 4));
+        createAIPlayer();
     }
     
     updateGameState();
@@ -26,7 +24,7 @@ void Connect4::displayBoard() const {
     for (int row = 0; row < ROWS; row++) {
         cout << "|";
         for (int col = 0; col < COLS; col++) {
-            cout << " " << board[row][col] << " |";
+            cout << " " << board.cellAt(row, col) << " |";
         }
         cout << endl;
         cout << "+---+---+---+---+---+---+---+" << endl;
@@ -35,16 +33,14 @@ void Connect4::displayBoard() const {
 }
 
 bool Connect4::isValidMove(int col) const {
-    return col >= 0 && col < COLS && board[0][col] == ' ';
+    return col >= 0 && col < COLS && board.canPlay(col);
 }
 
 int Connect4::getNextEmptyRow(int col) const {
-    for (int row = ROWS - 1; row >= 0; row--) {
-        if (board[row][col] == ' ') {
-            return row;
-        }
+    if (!board.canPlay(col)) {
+        return -1;
     }
-    return -1;
+    return ROWS - 1 - board.columnHeight(col);
 }
 
 bool Connect4::makeMove(int col) {
@@ -52,11 +48,19 @@ bool Connect4::makeMove(int col) {
         return false;
     }
     
-    int row = getNextEmptyRow(col);
-    board[row][col] = currentPlayer;
+    moveLog.record(col);
+    applyMove(col);
+    return true;
+}
+
+void Connect4::applyMove(int col) {
+    lastMoveRow = getNextEmptyRow(col);
+    lastMoveCol = col;
+    board.play(col, currentPlayer);
+    currentState = currentState.makeMove(col, currentPlayer);
     
     // Check for win after the move
-    if (checkWin(row, col)) {
+    if (checkWin(currentPlayer)) {
         gameOver = true;
         winner = currentPlayer;
     } else if (isBoardFull()) {
@@ -65,9 +69,6 @@ bool Connect4::makeMove(int col) {
     } else {
         switchPlayer();
     }
-    
-    updateGameState();
-    return true;
 }
 
 bool Connect4::playMove(int col) {
@@ -79,79 +80,17 @@ bool Connect4::playAIMove() {
         return false;
     }
     
+    stopPondering();
     int bestMove = aiPlayer->getBestMove(currentState);
     return makeMove(bestMove);
 }
 
-bool Connect4::checkWin(int row, int col) const {
-    return checkHorizontal(row, col) || checkVertical(row, col) || checkDiagonal(row, col);
-}
-
-bool Connect4::checkHorizontal(int row, int col) const {
-    char player = board[row][col];
-    int count = 1;
-    
-    // Check left
-    for (int c = col - 1; c >= 0 && board[row][c] == player; c--) {
-        count++;
-    }
-    
-    // Check right
-    for (int c = col + 1; c < COLS && board[row][c] == player; c++) {
-        count++;
-    }
-    
-    return count >= 4;
-}
-
-bool Connect4::checkVertical(int row, int col) const {
-    char player = board[row][col];
-    int count = 1;
-    
-    // Check up
-    for (int r = row - 1; r >= 0 && board[r][col] == player; r--) {
-        count++;
-    }
-    
-    // Check down
-    for (int r = row + 1; r < ROWS && board[r][col] == player; r++) {
-        count++;
-    }
-    
-    return count >= 4;
-}
-
-bool Connect4::checkDiagonal(int row, int col) const {
-    char player = board[row][col];
-    
-    // Check diagonal (top-left to bottom-right)
-    int count1 = 1;
-    for (int r = row - 1, c = col - 1; r >= 0 && c >= 0 && board[r][c] == player; r--, c--) {
-        count1++;
-    }
-    for (int r = row + 1, c = col + 1; r < ROWS && c < COLS && board[r][c] == player; r++, c++) {
-        count1++;
-    }
-    
-    // Check diagonal (top-right to bottom-left)
-    int count2 = 1;
-    for (int r = row - 1, c = col + 1; r >= 0 && c < COLS && board[r][c] == player; r--, c++) {
-        count2++;
-    }
-    for (int r = row + 1, c = col - 1; r < ROWS && c >= 0 && board[r][c] == player; r++, c--) {
-        count2++;
-    }
-    
-    return count1 >= 4 || count2 >= 4;
+bool Connect4::checkWin(char player) const {
+    return Bitboard::hasAlignment(board.stones(player));
 }
 
 bool Connect4::isBoardFull() const {
-    for (int col = 0; col < COLS; col++) {
-        if (board[0][col] == ' ') {
-            return false;
-        }
-    }
-    return true;
+    return board.isFull();
 }
 
 bool Connect4::isGameOver() const {
@@ -167,13 +106,18 @@ char Connect4::getCurrentPlayer() const {
 }
 
 void Connect4::resetGame() {
-    // Clear the board
-    for (int row = 0; row < ROWS; row++) {
-        for (int col = 0; col < COLS; col++) {
-            board[row][col] = ' ';
-        }
+    // Nothing the AI learned or is pondering carries over into the new game
+    if (aiPlayer) {
+        aiPlayer->stopPondering();
+        aiPlayer->newGame();
     }
     
+    // Clear the board
+    board = Bitboard();
+    lastMoveRow = -1;
+    lastMoveCol = -1;
+    moveLog.clear();
+    
     currentPlayer = 'X';
     gameOver = false;
     winner = ' ';
@@ -191,9 +135,12 @@ string Connect4::getGameStatus() const {
 }
 
 void Connect4::enableAI(bool enable) {
+    if (!enable) {
+        stopPondering();
+    }
     aiEnabled = enable;
     if (enable && !aiPlayer) {
-        aiPlayer = unique_ptr<AIPlayer>(new AIPlayer('O', 4));
+        createAIPlayer();
     }
 }
 
@@ -202,19 +149,127 @@ bool Connect4::isAIEnabled() const {
 }
 
 void Connect4::setAIDifficulty(int depth) {
+    aiDifficulty = depth;
+    if (aiPlayer) {
+        createAIPlayer();
+    }
+}
+
+void Connect4::setAIEngine(AIEngine engine) {
+    aiEngine = engine;
+    if (aiPlayer) {
+        createAIPlayer();
+    }
+}
+
+AIEngine Connect4::getAIEngine() const {
+    return aiEngine;
+}
+
+void Connect4::createAIPlayer() {
+    // The old engine may still be pondering
+    stopPondering();
+    if (aiEngine == ENGINE_MCTS) {
+        aiPlayer = unique_ptr<Engine>(new MCTSPlayer('O', MCTS_PLAYOUTS_PER_LEVEL * aiDifficulty));
+    } else {
+        aiPlayer = unique_ptr<Engine>(new AIPlayer('O', aiDifficulty));
+    }
+    aiPlayer->setOpeningBook(openingBook);
+}
+
+void Connect4::startPondering() {
+    if (ponderingEnabled && aiEnabled && aiPlayer && !gameOver && currentPlayer == 'X') {
+        aiPlayer->startPondering(currentState);
+    }
+}
+
+void Connect4::stopPondering() {
     if (aiPlayer) {
-        aiPlayer = unique_ptr<AIPlayer>(new AIPlayer('O', depth));
+        aiPlayer->stopPondering();
     }
 }
 
+void Connect4::setPondering(bool enable) {
+    ponderingEnabled = enable;
+    if (!enable) {
+        stopPondering();
+    }
+}
+
+bool Connect4::isPonderingEnabled() const {
+    return ponderingEnabled;
+}
+
+bool Connect4::loadOpeningBook(const string& path) {
+    shared_ptr<OpeningBook> book = make_shared<OpeningBook>();
+    if (!book->load(path)) {
+        return false;
+    }
+    
+    openingBook = book;
+    if (aiPlayer) {
+        aiPlayer->setOpeningBook(openingBook);
+    }
+    return true;
+}
+
 GameState Connect4::getCurrentGameState() const {
     return currentState;
 }
 
+const MoveLog& Connect4::getMoveLog() const {
+    return moveLog;
+}
+
 vector<GameState> Connect4::getGameHistory() const {
-    // This would require maintaining a history of states
-    // For now, return just the current state
-    return {currentState};
+    vector<GameState> history;
+    GameState state;
+    char player = 'X';
+    history.push_back(state);
+    
+    for (size_t ply = 0; ply < moveLog.size(); ply++) {
+        state = state.makeMove(moveLog.moveAt(ply), player);
+        history.push_back(state);
+        player = (player == 'X') ? 'O' : 'X';
+    }
+    return history;
+}
+
+bool Connect4::undoMove() {
+    int col = moveLog.undo();
+    if (col == -1) {
+        return false;
+    }
+    
+    // Whoever made the move is to move again, and no position before the
+    // last one can have ended the game
+    currentPlayer = board.cellAt(ROWS - board.columnHeight(col), col);
+    board.unplay(col);
+    gameOver = false;
+    winner = ' ';
+    
+    lastMoveCol = moveLog.lastMove();
+    lastMoveRow = lastMoveCol == -1 ? -1 : ROWS - board.columnHeight(lastMoveCol);
+    updateGameState();
+    return true;
+}
+
+bool Connect4::redoMove() {
+    int col = moveLog.redo();
+    if (col == -1) {
+        return false;
+    }
+    
+    applyMove(col);
+    return true;
+}
+
+bool Connect4::canUndo() const {
+    return moveLog.canUndo();
+}
+
+bool Connect4::canRedo() const {
+    return moveLog.canRedo();
 }
 
 int Connect4::evaluateCurrentPosition() const {
@@ -234,11 +289,10 @@ vector<int> Connect4::getValidMoves() const {
 bool Connect4::isWinningMove(int col) {
     if (!isValidMove(col)) return false;
     
-    int row = getNextEmptyRow(col);
-    // Create a temporary board to test the move
-    vector<vector<char>> tempBoard = board;
-    tempBoard[row][col] = currentPlayer;
-    bool isWin = checkWin(row, col);
+    // Test the move on a copy of the bitboard
+    Bitboard tempBoard = board;
+    tempBoard.play(col, currentPlayer);
+    bool isWin = Bitboard::hasAlignment(tempBoard.stones(currentPlayer));
     
     return isWin;
 }
@@ -247,17 +301,20 @@ bool Connect4::isBlockingMove(int col) {
     if (!isValidMove(col)) return false;
     
     char opponent = (currentPlayer == 'X') ? 'O' : 'X';
-    int row = getNextEmptyRow(col);
-    // Create a temporary board to test the move
-    vector<vector<char>> tempBoard = board;
-    tempBoard[row][col] = opponent;
-    bool isBlock = checkWin(row, col);
+    // Test the opponent's move on a copy of the bitboard
+    Bitboard tempBoard = board;
+    tempBoard.play(col, opponent);
+    bool isBlock = Bitboard::hasAlignment(tempBoard.stones(opponent));
     
     return isBlock;
 }
 
 void Connect4::updateGameState() {
-    currentState = GameState(board);
+    char lastPlayer = ' ';
+    if (lastMoveCol != -1) {
+        lastPlayer = board.cellAt(lastMoveRow, lastMoveCol);
+    }
+    currentState = GameState(board, lastMoveRow, lastMoveCol, lastPlayer, static_cast<int>(moveLog.size()));
 }
 
 void Connect4::switchPlayer() {
@@ -268,6 +325,7 @@ void Connect4::displayGameInfo() const {
     cout << "\n=== Game Information ===" << endl;
     cout << "Current Player: " << currentPlayer << endl;
     cout << "AI Enabled: " << (aiEnabled ? "Yes" : "No") << endl;
+    cout << "AI Engine: " << (aiEngine == ENGINE_MCTS ? "Monte Carlo tree search" : "Minimax") << endl;
     cout << "Position Score: " << evaluateCurrentPosition() << endl;
     cout << "Valid Moves: ";
     vector<int> moves = getValidMoves();
@@ -281,6 +339,7 @@ void Connect4::displayGameInfo() const {
 void Connect4::displayMoveHistory() const {
     cout << "\n=== Move History ===" << endl;
     cout << "Current state depth: " << currentState.getDepth() << endl;
+    cout << "Moves: " << (moveLog.size() > 0 ? moveLog.toString() : "none") << endl;
     cout << "Last move: Row " << currentState.getLastMoveRow() 
          << ", Col " << currentState.getLastMoveCol() 
          << " by Player " << currentState.getLastPlayer() << endl;
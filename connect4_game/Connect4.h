@@ -3,37 +3,54 @@
 
 #include "Node.h"
 #include "AIPlayer.h"
+#include "MCTSPlayer.h"
+#include "MoveLog.h"
 #include <vector>
 #include <string>
 #include <memory>
 
 using namespace std;
 
+// Search algorithms the AI can play with
+enum AIEngine {
+    ENGINE_MINIMAX,      // Alpha-beta search to a fixed depth
+    ENGINE_MCTS          // Monte Carlo tree search with a playout budget
+};
+
 // Enhanced Connect4 class with modular design
 class Connect4 {
 private:
-    static const int ROWS = 6;
-    static const int COLS = 7;
+    static const int ROWS = Bitboard::HEIGHT;
+    static const int COLS = Bitboard::WIDTH;
     
-    vector<vector<char>> board;
+    Bitboard board;
     char currentPlayer;
     bool gameOver;
     char winner;
     GameState currentState;
-    unique_ptr<AIPlayer> aiPlayer;
+    int lastMoveRow;
+    int lastMoveCol;
+    MoveLog moveLog;
+    unique_ptr<Engine> aiPlayer;
+    shared_ptr<const OpeningBook> openingBook;
     bool aiEnabled;
+    bool ponderingEnabled;
+    AIEngine aiEngine;
+    int aiDifficulty;
+    
+    // Playouts of the Monte Carlo engine per difficulty level
+    static const long long MCTS_PLAYOUTS_PER_LEVEL = 5000;
     
     // Helper methods
     bool isValidMove(int col) const;
     bool makeMove(int col);
-    bool checkWin(int row, int col) const;
-    bool checkHorizontal(int row, int col) const;
-    bool checkVertical(int row, int col) const;
-    bool checkDiagonal(int row, int col) const;
+    void applyMove(int col);
+    bool checkWin(char player) const;
     bool isBoardFull() const;
     int getNextEmptyRow(int col) const;
     void updateGameState();
     void switchPlayer();
+    void createAIPlayer();
 
 public:
     // Constructor
@@ -54,10 +71,35 @@ public:
     bool isAIEnabled() const;
     void setAIDifficulty(int depth);
     
+    // Choose the search algorithm of the AI; the difficulty is the search
+    // depth for minimax and MCTS_PLAYOUTS_PER_LEVEL playouts per level for MCTS
+    void setAIEngine(AIEngine engine);
+    AIEngine getAIEngine() const;
+    
+    // Load an opening book for the AI; returns false if it cannot be read
+    bool loadOpeningBook(const string& path);
+    
+    // Let the AI think on the human's time: start while waiting for the
+    // human move, stop as soon as it arrives
+    void startPondering();
+    void stopPondering();
+    void setPondering(bool enable);
+    bool isPonderingEnabled() const;
+    
     // Game state methods
     GameState getCurrentGameState() const;
+    const MoveLog& getMoveLog() const;
+    
+    // Every position of the game so far, starting with the empty board,
+    // replayed from the move log
     vector<GameState> getGameHistory() const;
     
+    // Take back the last move, or play it again after taking it back
+    bool undoMove();
+    bool redoMove();
+    bool canUndo() const;
+    bool canRedo() const;
+    
     // Analysis methods
     int evaluateCurrentPosition() const;
     vector<int> getValidMoves() const;
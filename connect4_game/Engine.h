@@ -0,0 +1,52 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "Node.h"
+#include "OpeningBook.h"
+#include "SearchStats.h"
+#include <chrono>
+#include <memory>
+
+using namespace std;
+
+// What every playing engine offers, for any board variant, so the game and
+// the tools can switch between search algorithms
+template <class Board>
+class BasicEngine {
+public:
+    typedef BasicGameState<Board> GameState;
+    
+    virtual ~BasicEngine() {}
+    
+    // Best move for the player to move, within the engine's own budget
+    virtual int getBestMove(const GameState& currentState) = 0;
+    
+    // Best move found within a time budget
+    virtual int getBestMove(const GameState& currentState, chrono::milliseconds timeBudget) = 0;
+    
+    // Interrupt the running search from another thread; the request also
+    // ends searches started later, until clearStop() is called
+    virtual void stop() = 0;
+    virtual void clearStop() = 0;
+    
+    // Think in the background while the opponent (to move in state) thinks,
+    // until stopPondering() is called
+    virtual void startPondering(const GameState& state) = 0;
+    virtual void stopPondering() = 0;
+    
+    // Number of search threads
+    virtual void setThreads(int threads) = 0;
+    
+    // Opening book consulted before searching (may be shared between players)
+    virtual void setOpeningBook(shared_ptr<const OpeningBook> book) = 0;
+    
+    // Forget everything learned from earlier games
+    virtual void newGame() = 0;
+    
+    // Statistics of the last getBestMove call
+    virtual const SearchStats& getLastStats() const = 0;
+};
+
+typedef BasicEngine<Bitboard> Engine;
+
+#endif
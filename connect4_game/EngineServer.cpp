@@ -0,0 +1,188 @@
+#include "EngineServer.h"
+#include "BatchAnalyzer.h"
+#include "Solver.h"
+#include <sstream>
+#include <climits>
+
+EngineServer::EngineServer(int threadCount, size_t hashSizeMB)
+    : threads(max(threadCount, 1)), hashMB(hashSizeMB), defaultDepth(12),
+      output(nullptr), infiniteSearch(false), activePlayer(nullptr), stopRequested(false) {}
+
+EngineServer::~EngineServer() {
+    stopSearch();
+}
+
+AIPlayer& EngineServer::playerToMove() {
+    char side = Solver::sideToMove(position);
+    if (!engine) {
+        engine = unique_ptr<AIPlayer>(new AIPlayer(side, defaultDepth, hashMB, threads));
+    }
+    engine->setSymbol(side);
+    return *engine;
+}
+
+void EngineServer::send(const string& line) {
+    lock_guard<mutex> lock(outputMutex);
+    *output << line << endl;
+}
+
+void EngineServer::stopSearch() {
+    // The engine keeps the request until the next go clears it, so it also
+    // ends a search that has not started yet
+    if (activePlayer) {
+        activePlayer->stop();
+    }
+    {
+        lock_guard<mutex> lock(stopMutex);
+        stopRequested = true;
+    }
+    stopCondition.notify_all();
+    waitForSearch();
+}
+
+void EngineServer::waitForSearch() {
+    if (searchThread.joinable()) {
+        searchThread.join();
+    }
+}
+
+void EngineServer::finishSearch() {
+    // An infinite search only ends when stopped
+    if (infiniteSearch) {
+        stopSearch();
+    } else {
+        waitForSearch();
+    }
+}
+
+void EngineServer::handlePosition(istream& args) {
+    string moves;
+    string token;
+    while (args >> token) {
+        if (token != "startpos" && token != "moves") {
+            moves += token;
+        }
+    }
+    
+    GameState state;
+    if (!moves.empty() && !BatchAnalyzer::parseMoves(moves, state)) {
+        send("error invalid position " + moves);
+        return;
+    }
+    position = state;
+}
+
+void EngineServer::handleGo(istream& args) {
+    if (position.isWinningState() || position.isDrawState()) {
+        send("error game over");
+        return;
+    }
+    
+    int moveTime = 0;
+    int depth = 0;
+    string token;
+    while (args >> token) {
+        if (token == "movetime") {
+            args >> moveTime;
+        } else if (token == "depth") {
+            args >> depth;
+        } else if (token == "infinite") {
+            moveTime = INT_MAX;
+        }
+    }
+    
+    // No search runs now, so the stop flags can be cleared before starting
+    AIPlayer& ai = playerToMove();
+    ai.clearStop();
+    activePlayer = &ai;
+    infiniteSearch = (moveTime == INT_MAX);
+    stopRequested = false;
+    GameState state = position;
+    
+    // Every search deepens iteratively, so a stopped one answers with its
+    // last completed depth
+    int depthLimit = depth > 0 ? depth : (moveTime > 0 ? INT_MAX : defaultDepth);
+    chrono::milliseconds budget(moveTime > 0 ? moveTime : INT_MAX);
+    searchThread = thread([this, &ai, state, budget, depthLimit]() {
+        int move = ai.getBestMove(state, budget, depthLimit);
+        
+        // An infinite search may reach the end of the game first; the
+        // answer still waits for stop
+        if (infiniteSearch) {
+            unique_lock<mutex> lock(stopMutex);
+            stopCondition.wait(lock, [this]() { return stopRequested; });
+        }
+        
+        const SearchStats& stats = ai.getLastStats();
+        ostringstream info;
+        info << "info depth " << stats.depth << " score " << stats.score << " nodes " << stats.nodes
+             << " time " << static_cast<long long>(stats.elapsedMs) << " pv";
+        for (int pvMove : stats.principalVariation) {
+            info << " " << pvMove + 1;
+        }
+        send(info.str());
+        send("bestmove " + to_string(move + 1));
+    });
+}
+
+void EngineServer::handleSetOption(istream& args) {
+    string name;
+    long long value = 0;
+    if (!(args >> name >> value) || value < 1) {
+        send("error invalid option");
+        return;
+    }
+    
+    if (name == "threads") {
+        threads = static_cast<int>(value);
+        if (engine) engine->setThreads(threads);
+    } else if (name == "hash") {
+        hashMB = static_cast<size_t>(value);
+        if (engine) engine->setHashSize(hashMB);
+    } else if (name == "depth") {
+        defaultDepth = static_cast<int>(value);
+    } else {
+        send("error unknown option " + name);
+    }
+}
+
+void EngineServer::run(istream& in, ostream& out) {
+    output = &out;
+    
+    string line;
+    while (getline(in, line)) {
+        istringstream args(line);
+        string command;
+        if (!(args >> command)) {
+            continue;
+        }
+        
+        if (command == "isready") {
+            send("readyok");
+        } else if (command == "stop") {
+            stopSearch();
+        } else if (command == "quit") {
+            stopSearch();
+            return;
+        } else {
+            // Everything else changes the engine state, so let a running search finish first
+            finishSearch();
+            
+            if (command == "position") {
+                handlePosition(args);
+            } else if (command == "go") {
+                handleGo(args);
+            } else if (command == "newgame") {
+                position = GameState();
+                if (engine) engine->clearHash();
+            } else if (command == "setoption") {
+                handleSetOption(args);
+            } else {
+                send("error unknown command " + command);
+            }
+        }
+    }
+    
+    // End of input: nobody can send stop any more
+    finishSearch();
+}
@@ -0,0 +1,90 @@
+#ifndef ENGINESERVER_H
+#define ENGINESERVER_H
+
+#include "AIPlayer.h"
+#include <iostream>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+// Persistent engine speaking a line protocol, in the spirit of UCI.
+//
+// Commands (one per line):
+//   isready                      answers "readyok"
+//   newgame                      forget everything learned in earlier games
+//   position [startpos] [moves] <columns>
+//                                set the position from the empty board, e.g.
+//                                "position 4453" or "position startpos moves 4 4 5 3"
+//   go [movetime N | depth D | infinite]
+//                                search the position for the player to move
+//   stop                         finish the running search now
+//   setoption threads N | hash MB | depth D
+//   quit
+//
+// A search runs in the background so stop and isready are answered while it
+// runs; it ends with an "info" line and "bestmove <column>" (columns 1-7).
+// Searches deepen iteratively up to the requested depth, and stop ends any
+// of them with the result of the last completed depth. An infinite search
+// answers only after stop, even when it has searched to the end of the game.
+// Other commands wait for a running search to finish, except that an
+// infinite search is stopped first.
+//
+// One engine searches for whichever side is to move. It keeps its
+// transposition table (hash MB in total) and helper threads between
+// searches, so a game served by one process keeps the table warm for both
+// sides.
+class EngineServer {
+private:
+    unique_ptr<AIPlayer> engine;         // Created on demand
+    GameState position;
+    int threads;
+    size_t hashMB;
+    int defaultDepth;
+    
+    ostream* output;
+    mutex outputMutex;
+    thread searchThread;
+    bool infiniteSearch;
+    AIPlayer* activePlayer;
+    
+    // Set by stop; an infinite search holds its answer until then
+    bool stopRequested;
+    mutex stopMutex;
+    condition_variable stopCondition;
+    
+    // The engine, playing the side to move in the current position
+    AIPlayer& playerToMove();
+    
+    // Command handlers
+    void handlePosition(istream& args);
+    void handleGo(istream& args);
+    void handleSetOption(istream& args);
+    
+    // Interrupt the running search, if any, and wait for its bestmove
+    void stopSearch();
+    
+    // Wait for the running search to finish on its own
+    void waitForSearch();
+    
+    // Wait for the running search, stopping it if it would never end
+    void finishSearch();
+    
+    // Write a line of output
+    void send(const string& line);
+
+public:
+    // Constructor
+    EngineServer(int threadCount = 1, size_t hashSizeMB = 64);
+    
+    // Destructor
+    ~EngineServer();
+    
+    // Process commands until quit or the end of the input
+    void run(istream& in, ostream& out);
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include "Evaluator.h"
+
+// The AVX2 scan reads 64-bit lanes into general registers, which only
+// x86-64 has; every other target uses the scalar scan
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define EVALUATOR_AVX2 1
+#endif
+
+namespace {
+
+// Inverts the window list into a per-cell lookup
+template <class Board>
+struct CellWindowTable {
+    typedef typename BasicEvaluator<Board>::CellWindows CellWindows;
+    typedef typename Board::Word Word;
+    
+    CellWindows cells[Board::WORD_BITS];
+    
+    CellWindowTable() {
+        for (int bit = 0; bit < Board::WORD_BITS; bit++) {
+            cells[bit].count = 0;
+        }
+        
+        const Word* windows = Board::windowMasks();
+        for (int i = 0; i < Board::NUM_WINDOWS; i++) {
+            for (Word rest = windows[i]; rest; rest &= rest - 1) {
+                CellWindows& cell = cells[lowestBit(rest)];
+                cell.masks[cell.count++] = windows[i];
+            }
+        }
+    }
+};
+
+// Window masks padded with empty windows to a multiple of four; an empty
+// window scores nothing
+template <class Board>
+struct PaddedWindowTable {
+    static const int COUNT = (Board::NUM_WINDOWS + 3) / 4 * 4;
+    alignas(32) uint64_t masks[COUNT];
+    
+    PaddedWindowTable() {
+        const typename Board::Word* windows = Board::windowMasks();
+        for (int i = 0; i < COUNT; i++) {
+            masks[i] = i < Board::NUM_WINDOWS ? static_cast<uint64_t>(windows[i]) : 0;
+        }
+    }
+};
+
+#ifdef EVALUATOR_AVX2
+
+// Popcount of every 64-bit lane: nibble lookups summed per lane
+__attribute__((target("avx2")))
+inline __m256i popCount4(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low)),
+                                     _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+    return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+// Window scores of count windows, four per iteration. With a and h the
+// piece counts of a window, a * a counts only when h is zero and h * h only
+// when a is zero, which matches windowScore without branches
+__attribute__((target("avx2")))
+int scoreWindowsAvx2(uint64_t ai, uint64_t human, const uint64_t* windows, int count) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i aiStones = _mm256_set1_epi64x(static_cast<long long>(ai));
+    __m256i humanStones = _mm256_set1_epi64x(static_cast<long long>(human));
+    __m256i aiSum = zero;
+    __m256i humanSum = zero;
+    
+    for (int i = 0; i < count; i += 4) {
+        __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(windows + i));
+        __m256i a = popCount4(_mm256_and_si256(aiStones, w));
+        __m256i h = popCount4(_mm256_and_si256(humanStones, w));
+        aiSum = _mm256_add_epi64(aiSum, _mm256_and_si256(_mm256_mul_epu32(a, a), _mm256_cmpeq_epi64(h, zero)));
+        humanSum = _mm256_add_epi64(humanSum, _mm256_and_si256(_mm256_mul_epu32(h, h), _mm256_cmpeq_epi64(a, zero)));
+    }
+    
+    __m256i diff = _mm256_sub_epi64(aiSum, humanSum);
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(diff), _mm256_extracti128_si256(diff, 1));
+    long long total = _mm_cvtsi128_si64(half) + _mm_extract_epi64(half, 1);
+    return static_cast<int>(total) * 10;
+}
+
+bool cpuHasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#else
+
+int scoreWindowsAvx2(uint64_t, uint64_t, const uint64_t*, int) {
+    return 0;
+}
+
+bool cpuHasAvx2() {
+    return false;
+}
+
+#endif
+
+// The vector code works on 64-bit words only
+template <class Board>
+bool fitsVector() {
+    return sizeof(typename Board::Word) == sizeof(uint64_t);
+}
+
+}
+
+template <class Board>
+const typename BasicEvaluator<Board>::CellWindows* BasicEvaluator<Board>::cellTable() {
+    static const CellWindowTable<Board> table;
+    return table.cells;
+}
+
+template <class Board>
+bool BasicEvaluator<Board>::hasVectorEvaluate() {
+    return fitsVector<Board>() && cpuHasAvx2();
+}
+
+template <class Board>
+int BasicEvaluator<Board>::evaluate(const Board& board) {
+    static const bool vector = hasVectorEvaluate();
+    return vector ? evaluateVector(board) : evaluateScalar(board);
+}
+
+template <class Board>
+int BasicEvaluator<Board>::evaluateVector(const Board& board) {
+    if (!hasVectorEvaluate()) {
+        return evaluateScalar(board);
+    }
+    
+    static const PaddedWindowTable<Board> table;
+    return scoreWindowsAvx2(static_cast<uint64_t>(board.getOStones()), static_cast<uint64_t>(board.getXStones()),
+                            table.masks, PaddedWindowTable<Board>::COUNT);
+}
+
+template <class Board>
+int BasicEvaluator<Board>::evaluateScalar(const Board& board) {
+    int score = 0;
+    Word ai = board.getOStones();
+    Word human = board.getXStones();
+    const Word* windows = Board::windowMasks();
+    
+    // Evaluate every horizontal, vertical and diagonal window
+    for (int i = 0; i < Board::NUM_WINDOWS; i++) {
+        score += windowScore(popCount(ai & windows[i]), popCount(human & windows[i]));
+    }
+    
+    return score;
+}
+
+template <class Board>
+int BasicEvaluator<Board>::moveDelta(Word ai, Word human, Word move, char player) {
+    const CellWindows& cell = windowsThrough(lowestBit(move));
+    int delta = 0;
+    
+    // Only the windows through the new piece change
+    for (int i = 0; i < cell.count; i++) {
+        int aiCount = popCount(ai & cell.masks[i]);
+        int humanCount = popCount(human & cell.masks[i]);
+        int before = windowScore(aiCount, humanCount);
+        
+        if (player == 'X') humanCount++;
+        else aiCount++;
+        
+        delta += windowScore(aiCount, humanCount) - before;
+    }
+    
+    return delta;
+}
+
+template class BasicEvaluator<Bitboard>;
+template class BasicEvaluator<Bitboard8x7>;
+template class BasicEvaluator<Bitboard9x7>;
+template class BasicEvaluator<Bitboard9x6Connect5>;
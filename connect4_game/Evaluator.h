@@ -0,0 +1,64 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "Bitboard.h"
+
+using namespace std;
+
+// Heuristic evaluation of the CONNECT-cell windows of a board (69 on 7x6).
+// A window holding only 'O' pieces scores +10 * count^2, one holding only 'X'
+// pieces scores -10 * count^2 and mixed or empty windows score nothing.
+// Besides the full scan, the evaluator can compute the change caused by a
+// single move from the windows through that cell, so a search can keep the
+// score up to date incrementally instead of rescanning the board at every leaf.
+template <class Board>
+class BasicEvaluator {
+public:
+    typedef typename Board::Word Word;
+    
+    // A cell lies in at most CONNECT windows per direction
+    static const int MAX_WINDOWS_PER_CELL = 4 * Board::CONNECT;
+    
+    // Windows passing through one cell
+    struct CellWindows {
+        int count;
+        Word masks[MAX_WINDOWS_PER_CELL];
+    };
+
+private:
+    static const CellWindows* cellTable();
+
+public:
+    // Score of a single window given its piece counts
+    static int windowScore(int aiCount, int humanCount) {
+        if (aiCount > 0 && humanCount == 0) return aiCount * aiCount * 10;
+        if (humanCount > 0 && aiCount == 0) return -humanCount * humanCount * 10;
+        return 0;
+    }
+    
+    // Full scan of every window, with the fastest implementation this CPU runs
+    static int evaluate(const Board& board);
+    
+    // The full scan one window at a time, and four windows at a time with
+    // AVX2 (boards stored in 64 bits only, otherwise the scalar scan)
+    static int evaluateScalar(const Board& board);
+    static int evaluateVector(const Board& board);
+    
+    // Check if evaluateVector really runs vectorized here
+    static bool hasVectorEvaluate();
+    
+    // Score change when player drops a piece on the empty cell 'move' of board
+    static int moveDelta(const Board& board, Word move, char player) {
+        return moveDelta(board.getOStones(), board.getXStones(), move, player);
+    }
+    
+    // The same given the stones of 'O' (ai) and 'X' (human)
+    static int moveDelta(Word ai, Word human, Word move, char player);
+    
+    // Windows through the cell at a bit index
+    static const CellWindows& windowsThrough(int bit) { return cellTable()[bit]; }
+};
+
+typedef BasicEvaluator<Bitboard> Evaluator;
+
+#endif
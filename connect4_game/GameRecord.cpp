@@ -0,0 +1,187 @@
+#include "GameRecord.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[8] = { 'C', '4', 'G', 'A', 'M', 'E', 'S', 0 };
+
+}
+
+GameResult resultOf(const GameState& state) {
+    if (state.isWinningState()) {
+        return state.getLastPlayer() == 'X' ? RESULT_X_WINS : RESULT_O_WINS;
+    }
+    return state.isDrawState() ? RESULT_DRAW : RESULT_UNKNOWN;
+}
+
+int GameRecordView::score(int ply) const {
+    if (!scores) {
+        return 0;
+    }
+    const uint8_t* p = data + recordSize(moveCount(), false) + 2 * ply;
+    return static_cast<int16_t>(p[0] | p[1] << 8);
+}
+
+string GameRecordView::moveString() const {
+    string text;
+    for (int ply = 0; ply < moveCount(); ply++) {
+        text += static_cast<char>('1' + move(ply));
+    }
+    return text;
+}
+
+GameRecordWriter::GameRecordWriter() : scores(false), gameCount(0) {}
+
+GameRecordWriter::~GameRecordWriter() {
+    close();
+}
+
+bool GameRecordWriter::open(const string& path, bool withScores) {
+    close();
+    out.open(path.c_str(), ios::binary | ios::trunc);
+    if (!out) {
+        return false;
+    }
+    scores = withScores;
+    gameCount = 0;
+    
+    // The game count is written again once it is known
+    GameArchiveHeader h;
+    memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = GameArchiveHeader::VERSION;
+    h.flags = withScores ? GameArchiveHeader::FLAG_SCORES : 0;
+    h.gameCount = 0;
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    return static_cast<bool>(out);
+}
+
+bool GameRecordWriter::write(const vector<int>& moves, GameResult result, const vector<int>& moveScores) {
+    if (!out.is_open() || moves.size() > 255 || (scores && moveScores.size() != moves.size())) {
+        return false;
+    }
+    
+    int count = static_cast<int>(moves.size());
+    buffer.assign(GameRecordView::recordSize(count, scores), 0);
+    buffer[0] = static_cast<uint8_t>(count);
+    buffer[1] = static_cast<uint8_t>(result);
+    
+    for (int ply = 0; ply < count; ply++) {
+        if (moves[ply] < 0 || moves[ply] >= Bitboard::WIDTH) {
+            return false;
+        }
+        int bit = 3 * ply;
+        unsigned bits = static_cast<unsigned>(moves[ply]) << (bit % 8);
+        buffer[2 + bit / 8] |= static_cast<uint8_t>(bits);
+        if (bits >> 8) {
+            buffer[3 + bit / 8] |= static_cast<uint8_t>(bits >> 8);
+        }
+    }
+    
+    if (scores) {
+        uint8_t* p = buffer.data() + GameRecordView::recordSize(count, false);
+        for (int ply = 0; ply < count; ply++) {
+            int value = max(-32768, min(32767, moveScores[ply]));
+            p[2 * ply] = static_cast<uint8_t>(value & 0xFF);
+            p[2 * ply + 1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        }
+    }
+    
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    gameCount++;
+    return static_cast<bool>(out);
+}
+
+bool GameRecordWriter::close() {
+    if (!out.is_open()) {
+        return true;
+    }
+    out.seekp(offsetof(GameArchiveHeader, gameCount));
+    out.write(reinterpret_cast<const char*>(&gameCount), sizeof(gameCount));
+    bool ok = static_cast<bool>(out);
+    out.close();
+    return ok;
+}
+
+GameRecordReader::GameRecordReader()
+    : mapping(nullptr), mappingSize(0), header(nullptr), offset(0), damaged(false) {}
+
+GameRecordReader::~GameRecordReader() {
+    close();
+}
+
+bool GameRecordReader::open(const string& path) {
+    close();
+    
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(GameArchiveHeader)) {
+        ::close(fd);
+        return false;
+    }
+    
+    size_t length = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    
+    // Records are read front to back, so tell the kernel to read ahead
+    madvise(data, length, MADV_SEQUENTIAL);
+    
+    const GameArchiveHeader* h = static_cast<const GameArchiveHeader*>(data);
+    if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != GameArchiveHeader::VERSION) {
+        munmap(data, length);
+        return false;
+    }
+    
+    mapping = data;
+    mappingSize = length;
+    header = h;
+    rewind();
+    return true;
+}
+
+void GameRecordReader::close() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    offset = 0;
+    damaged = false;
+}
+
+bool GameRecordReader::next(GameRecordView& game) {
+    if (!header || offset >= mappingSize) {
+        return false;
+    }
+    
+    // The move count byte tells the record size; check it fits before use
+    const uint8_t* record = static_cast<const uint8_t*>(mapping) + offset;
+    size_t size = mappingSize - offset < 2 ? 0 : GameRecordView::recordSize(record[0], hasScores());
+    if (size == 0 || size > mappingSize - offset) {
+        damaged = true;
+        offset = mappingSize;
+        return false;
+    }
+    
+    game = GameRecordView(record, hasScores());
+    offset += size;
+    return true;
+}
+
+void GameRecordReader::rewind() {
+    offset = sizeof(GameArchiveHeader);
+    damaged = false;
+}
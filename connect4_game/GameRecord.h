@@ -0,0 +1,173 @@
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include "Node.h"
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Outcome stored with a game
+enum GameResult : uint8_t {
+    RESULT_UNKNOWN = 0,   // Unfinished, or the result was not recorded
+    RESULT_X_WINS = 1,
+    RESULT_O_WINS = 2,
+    RESULT_DRAW = 3
+};
+
+// Result of the game that led to a state
+GameResult resultOf(const GameState& state);
+
+// Compact binary archive of games.
+//
+// File layout (little-endian):
+//   header   magic "C4GAMES\0", uint32 version, uint32 flags, uint64 game count
+//   records  one per game, back to back:
+//            uint8 move count, uint8 result,
+//            the columns at 3 bits each, packed from the lowest bit of each
+//            byte up and padded to a whole byte,
+//            with FLAG_SCORES: one int16 engine score per move
+//
+// A full 7x6 game takes 18 bytes without scores. Records have no fixed size,
+// so an archive is read front to back.
+struct GameArchiveHeader {
+    static const uint32_t VERSION = 1;
+    static const uint32_t FLAG_SCORES = 1;   // Every move carries an engine score
+    
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t gameCount;
+};
+
+// One game inside a mapped archive, read in place; valid while the reader
+// that returned it stays open
+class GameRecordView {
+private:
+    const uint8_t* data;
+    bool scores;
+
+public:
+    GameRecordView() : data(nullptr), scores(false) {}
+    GameRecordView(const uint8_t* record, bool withScores) : data(record), scores(withScores) {}
+    
+    int moveCount() const { return data[0]; }
+    GameResult result() const { return static_cast<GameResult>(data[1] & 0x3); }
+    bool hasScores() const { return scores; }
+    
+    // Column of a move (values above 6 mean the record is damaged)
+    int move(int ply) const {
+        int bit = 3 * ply;
+        unsigned bits = data[2 + bit / 8] >> (bit % 8);
+        if (bit % 8 > 5) {
+            bits |= data[3 + bit / 8] << (8 - bit % 8);
+        }
+        return bits & 0x7;
+    }
+    
+    // Decode every move into columns, which needs room for moveCount()
+    // entries; faster than reading the moves one by one
+    void decodeMoves(uint8_t* columns) const {
+        const uint8_t* packed = data + 2;
+        unsigned bits = 0;
+        int available = 0;
+        for (int ply = 0; ply < moveCount(); ply++) {
+            if (available < 3) {
+                bits |= static_cast<unsigned>(*packed++) << available;
+                available += 8;
+            }
+            columns[ply] = static_cast<uint8_t>(bits & 0x7);
+            bits >>= 3;
+            available -= 3;
+        }
+    }
+    
+    // Engine score stored with a move (0 without scores)
+    int score(int ply) const;
+    
+    // Moves as columns from 1, e.g. "4453"
+    string moveString() const;
+    
+    // Bytes taken by a record with the given number of moves
+    static size_t recordSize(int moveCount, bool withScores) {
+        return 2 + (3 * moveCount + 7) / 8 + (withScores ? 2 * moveCount : 0);
+    }
+};
+
+// Writes an archive game by game through a buffered stream, so memory use
+// does not grow with the number of games. The game count in the header is
+// filled in by close().
+class GameRecordWriter {
+private:
+    ofstream out;
+    bool scores;
+    uint64_t gameCount;
+    vector<uint8_t> buffer;
+
+public:
+    // Constructor
+    GameRecordWriter();
+    
+    // Destructor
+    ~GameRecordWriter();
+    
+    // Create an archive; with scores every game must come with one score per move
+    bool open(const string& path, bool withScores);
+    
+    // Append a game; scores are clamped to 16 bits and ignored by an archive
+    // without scores. Returns false on a write error or an invalid game.
+    bool write(const vector<int>& moves, GameResult result, const vector<int>& moveScores = vector<int>());
+    
+    // Complete the header and close the file
+    bool close();
+    
+    bool isOpen() const { return out.is_open(); }
+    uint64_t size() const { return gameCount; }
+};
+
+// Maps an archive read-only with mmap and walks its records in place; no game
+// is copied or decoded until its moves are read.
+class GameRecordReader {
+private:
+    void* mapping;
+    size_t mappingSize;
+    const GameArchiveHeader* header;
+    size_t offset;
+    bool damaged;
+    
+    // A mapped archive cannot be copied
+    GameRecordReader(const GameRecordReader&);
+    GameRecordReader& operator=(const GameRecordReader&);
+
+public:
+    // Constructor
+    GameRecordReader();
+    
+    // Destructor
+    ~GameRecordReader();
+    
+    // Map an archive; returns false if it is missing or has no valid header
+    bool open(const string& path);
+    
+    // Unmap the current archive
+    void close();
+    
+    // Move to the next game; returns false after the last one or at a
+    // truncated record (see isDamaged)
+    bool next(GameRecordView& game);
+    
+    // Start again from the first game
+    void rewind();
+    
+    // Archive information
+    bool isOpen() const { return header != nullptr; }
+    bool hasScores() const { return header && (header->flags & GameArchiveHeader::FLAG_SCORES); }
+    uint64_t size() const { return header ? header->gameCount : 0; }
+    size_t bytes() const { return mappingSize; }
+    bool isDamaged() const { return damaged; }
+};
+
+#endif
@@ -2,22 +2,23 @@
 #include <algorithm>
 #include <climits>
 
-bool GameState::isWinningState() const {
+template <class Board>
+bool BasicGameState<Board>::isWinningState() const {
     if (lastMoveRow == -1 || lastMoveCol == -1) return false;
     return checkWin(lastMoveRow, lastMoveCol);
 }
 
-bool GameState::isDrawState() const {
+template <class Board>
+bool BasicGameState<Board>::isDrawState() const {
     // Check if all top positions are filled
-    for (int col = 0; col < 7; col++) {
-        if (board[0][col] == ' ') {
-            return false;
-        }
+    if (!board.isFull()) {
+        return false;
     }
     return !isWinningState();
 }
 
-int GameState::evaluateState() const {
+template <class Board>
+int BasicGameState<Board>::evaluateState() const {
     if (isWinningState()) {
         return (lastPlayer == 'O') ? 1000 : -1000; // AI wins = positive, Human wins = negative
     }
@@ -25,91 +26,16 @@ int GameState::evaluateState() const {
         return 0;
     }
     
-    int score = 0;
-    
-    // Evaluate horizontal lines
-    for (int row = 0; row < 6; row++) {
-        for (int col = 0; col < 4; col++) {
-            int aiCount = 0, humanCount = 0, emptyCount = 0;
-            
-            for (int i = 0; i < 4; i++) {
-                if (board[row][col + i] == 'O') aiCount++;
-                else if (board[row][col + i] == 'X') humanCount++;
-                else emptyCount++;
-            }
-            
-            if (aiCount > 0 && humanCount == 0) {
-                score += aiCount * aiCount * 10;
-            } else if (humanCount > 0 && aiCount == 0) {
-                score -= humanCount * humanCount * 10;
-            }
-        }
-    }
-    
-    // Evaluate vertical lines
-    for (int col = 0; col < 7; col++) {
-        for (int row = 0; row < 3; row++) {
-            int aiCount = 0, humanCount = 0, emptyCount = 0;
-            
-            for (int i = 0; i < 4; i++) {
-                if (board[row + i][col] == 'O') aiCount++;
-                else if (board[row + i][col] == 'X') humanCount++;
-                else emptyCount++;
-            }
-            
-            if (aiCount > 0 && humanCount == 0) {
-                score += aiCount * aiCount * 10;
-            } else if (humanCount > 0 && aiCount == 0) {
-                score -= humanCount * humanCount * 10;
-            }
-        }
-    }
-    
-    // Evaluate diagonal lines (top-left to bottom-right)
-    for (int row = 0; row < 3; row++) {
-        for (int col = 0; col < 4; col++) {
-            int aiCount = 0, humanCount = 0, emptyCount = 0;
-            
-            for (int i = 0; i < 4; i++) {
-                if (board[row + i][col + i] == 'O') aiCount++;
-                else if (board[row + i][col + i] == 'X') humanCount++;
-                else emptyCount++;
-            }
-            
-            if (aiCount > 0 && humanCount == 0) {
-                score += aiCount * aiCount * 10;
-            } else if (humanCount > 0 && aiCount == 0) {
-                score -= humanCount * humanCount * 10;
-            }
-        }
-    }
-    
-    // Evaluate diagonal lines (top-right to bottom-left)
-    for (int row = 0; row < 3; row++) {
-        for (int col = 3; col < 7; col++) {
-            int aiCount = 0, humanCount = 0, emptyCount = 0;
-            
-            for (int i = 0; i < 4; i++) {
-                if (board[row + i][col - i] == 'O') aiCount++;
-                else if (board[row + i][col - i] == 'X') humanCount++;
-                else emptyCount++;
-            }
-            
-            if (aiCount > 0 && humanCount == 0) {
-                score += aiCount * aiCount * 10;
-            } else if (humanCount > 0 && aiCount == 0) {
-                score -= humanCount * humanCount * 10;
-            }
-        }
-    }
-    
-    return score;
+    // Window scores are maintained incrementally by makeMove
+    return heuristic;
 }
 
-vector<GameState> GameState::generateNextStates(char player) const {
-    vector<GameState> nextStates;
+template <class Board>
+vector<BasicGameState<Board>> BasicGameState<Board>::generateNextStates(char player) const {
+    vector<BasicGameState> nextStates;
+    nextStates.reserve(Board::WIDTH);
     
-    for (int col = 0; col < 7; col++) {
+    for (int col = 0; col < Board::WIDTH; col++) {
         if (isValidMove(col)) {
             nextStates.push_back(makeMove(col, player));
         }
@@ -118,87 +44,51 @@ vector<GameState> GameState::generateNextStates(char player) const {
     return nextStates;
 }
 
-bool GameState::isValidMove(int col) const {
-    return col >= 0 && col < 7 && board[0][col] == ' ';
+template <class Board>
+bool BasicGameState<Board>::isValidMove(int col) const {
+    return col >= 0 && col < Board::WIDTH && board.canPlay(col);
 }
 
-GameState GameState::makeMove(int col, char player) const {
-    vector<vector<char>> newBoard = board;
-    
-    // Find the lowest empty row in the column
-    int row = -1;
-    for (int r = 5; r >= 0; r--) {
-        if (newBoard[r][col] == ' ') {
-            row = r;
-            break;
-        }
+template <class Board>
+BasicGameState<Board> BasicGameState<Board>::makeMove(int col, char player) const {
+    if (!board.canPlay(col)) {
+        return BasicGameState(board, -1, col, player, depth + 1, 0, heuristic);
     }
     
-    if (row != -1) {
-        newBoard[row][col] = player;
-    }
+    Board newBoard = board;
+    typename Board::Word move = newBoard.play(col, player);
+    int row = Board::rowOf(move);
+    
+    // Only the windows through the new piece change
+    int newHeuristic = heuristic + Evaluator::moveDelta(board, move, player);
     
-    return GameState(newBoard, row, col, player, depth + 1);
+    return BasicGameState(newBoard, row, col, player, depth + 1, 0, newHeuristic);
 }
 
-bool GameState::checkWin(int row, int col) const {
+template <class Board>
+bool BasicGameState<Board>::checkWin(int row, int col) const {
     return checkHorizontal(row, col) || checkVertical(row, col) || checkDiagonal(row, col);
 }
 
-bool GameState::checkHorizontal(int row, int col) const {
-    char player = board[row][col];
-    int count = 1;
-    
-    // Check left
-    for (int c = col - 1; c >= 0 && board[row][c] == player; c--) {
-        count++;
-    }
-    
-    // Check right
-    for (int c = col + 1; c < 7 && board[row][c] == player; c++) {
-        count++;
-    }
-    
-    return count >= 4;
+template <class Board>
+bool BasicGameState<Board>::checkHorizontal(int row, int col) const {
+    char player = board.cellAt(row, col);
+    return player != ' ' && Board::alignedHorizontal(board.stones(player));
 }
 
-bool GameState::checkVertical(int row, int col) const {
-    char player = board[row][col];
-    int count = 1;
-    
-    // Check up
-    for (int r = row - 1; r >= 0 && board[r][col] == player; r--) {
-        count++;
-    }
-    
-    // Check down
-    for (int r = row + 1; r < 6 && board[r][col] == player; r++) {
-        count++;
-    }
-    
-    return count >= 4;
+template <class Board>
+bool BasicGameState<Board>::checkVertical(int row, int col) const {
+    char player = board.cellAt(row, col);
+    return player != ' ' && Board::alignedVertical(board.stones(player));
 }
 
-bool GameState::checkDiagonal(int row, int col) const {
-    char player = board[row][col];
-    
-    // Check diagonal (top-left to bottom-right)
-    int count1 = 1;
-    for (int r = row - 1, c = col - 1; r >= 0 && c >= 0 && board[r][c] == player; r--, c--) {
-        count1++;
-    }
-    for (int r = row + 1, c = col + 1; r < 6 && c < 7 && board[r][c] == player; r++, c++) {
-        count1++;
-    }
-    
-    // Check diagonal (top-right to bottom-left)
-    int count2 = 1;
-    for (int r = row - 1, c = col + 1; r >= 0 && c < 7 && board[r][c] == player; r--, c++) {
-        count2++;
-    }
-    for (int r = row + 1, c = col - 1; r < 6 && c >= 0 && board[r][c] == player; r++, c--) {
-        count2++;
-    }
-    
-    return count1 >= 4 || count2 >= 4;
+template <class Board>
+bool BasicGameState<Board>::checkDiagonal(int row, int col) const {
+    char player = board.cellAt(row, col);
+    return player != ' ' && Board::alignedDiagonal(board.stones(player));
 }
+
+template class BasicGameState<Bitboard>;
+template class BasicGameState<Bitboard8x7>;
+template class BasicGameState<Bitboard9x7>;
+template class BasicGameState<Bitboard9x6Connect5>;
@@ -0,0 +1,484 @@
+#include "MCTSPlayer.h"
+#include <climits>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Only the standard board has opening books
+int lookupBook(const OpeningBook& book, const Bitboard& board) {
+    return book.lookup(board);
+}
+
+template <class Board>
+int lookupBook(const OpeningBook&, const Board&) {
+    return -1;
+}
+
+// splitmix64: a fast generator whose state may take any value
+uint64_t nextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// One of the set bits, chosen at random
+template <class Word>
+Word randomBit(Word bits, uint64_t& random) {
+    int skip = static_cast<int>(nextRandom(random) % static_cast<uint64_t>(popCount(bits)));
+    for (int i = 0; i < skip; i++) {
+        bits &= bits - 1;
+    }
+    return Word(1) << lowestBit(bits);
+}
+
+char otherPlayer(char player) {
+    return player == 'X' ? 'O' : 'X';
+}
+
+}
+
+template <class Board>
+BasicMCTSPlayer<Board>::BasicMCTSPlayer(char symbol, long long playouts, size_t treeSizeMB, int threads)
+    : playerSymbol(symbol), maxPlayouts(max(playouts, 1LL)), treeBytes(max<size_t>(treeSizeMB, 1) * 1024 * 1024),
+      threadCount(max(threads, 1)), exploration(1.0), heavyPlayouts(true), randomSeed(1), capacity(0),
+      nodeCount(0), treeFull(false), rootPlayer('X'), hasTree(false), reusedNodes(0), stopSearch(false), stopRequested(false) {}
+
+template <class Board>
+BasicMCTSPlayer<Board>::~BasicMCTSPlayer() {
+    stopPondering();
+}
+
+template <class Board>
+void BasicMCTSPlayer<Board>::setTreeSize(size_t sizeMB) {
+    treeBytes = max<size_t>(sizeMB, 1) * 1024 * 1024;
+    tree.reset();
+    spareTree.reset();
+    hasTree = false;
+}
+
+template <class Board>
+int BasicMCTSPlayer<Board>::getBestMove(const GameState& currentState) {
+    return search(currentState, maxPlayouts, false, chrono::steady_clock::time_point());
+}
+
+template <class Board>
+int BasicMCTSPlayer<Board>::getBestMove(const GameState& currentState, chrono::milliseconds timeBudget) {
+    return search(currentState, LLONG_MAX, true, chrono::steady_clock::now() + timeBudget);
+}
+
+template <class Board>
+int BasicMCTSPlayer<Board>::search(const GameState& state, long long playouts, bool timed,
+                                   chrono::steady_clock::time_point deadline) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    lastStats.reset();
+    if (state.isWinningState() || state.isDrawState()) {
+        return Board::WIDTH / 2;
+    }
+    
+    int bookMove = findBookMove(state);
+    if (bookMove != -1) {
+        lastStats.bestMove = bookMove;
+        lastStats.principalVariation.assign(1, bookMove);
+        return bookMove;
+    }
+    
+    // A forced move (a win, the only block or the only legal move) needs no search
+    prepareTree(state);
+    long long done = 0;
+    int depth = 0;
+    if (tree[0].firstChild < 0 || tree[0].childCount > 1) {
+        runSearch(playouts, timed, deadline, done, depth);
+    }
+    
+    // The most visited move, and the line of most visited replies
+    int best = bestChild(0);
+    int move = -1;
+    if (best != -1) {
+        move = tree[best].move;
+        const TreeNode& node = tree[best];
+        if (node.result >= 0) {
+            lastStats.score = (node.result - 1) * 1000;
+        } else if (node.visits > 0) {
+            lastStats.score = static_cast<int>(lround(1000.0 * node.reward / node.visits - 1000.0));
+        }
+        for (int index = best; index != -1; index = bestChild(index)) {
+            lastStats.principalVariation.push_back(tree[index].move);
+        }
+    } else {
+        // Nothing was searched: take the most central legal move
+        for (int i = 0; i < Board::WIDTH && move == -1; i++) {
+            int col = Board::WIDTH / 2 + (i % 2 ? -(i + 1) / 2 : i / 2);
+            if (state.isValidMove(col)) {
+                move = col;
+            }
+        }
+        lastStats.principalVariation.assign(1, move);
+    }
+    
+    lastStats.nodes = done;
+    lastStats.depth = depth;
+    lastStats.bestMove = move;
+    lastStats.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return move;
+}
+
+template <class Board>
+int BasicMCTSPlayer<Board>::findBookMove(const GameState& state) const {
+    // Book moves are stored for the player to move, which must be this player
+    if (!openingBook || state.getLastPlayer() == playerSymbol) {
+        return -1;
+    }
+    
+    int move = lookupBook(*openingBook, state.getBoard());
+    if (move == -1 || !state.getBoard().canPlay(move)) {
+        return -1;
+    }
+    return move;
+}
+
+template <class Board>
+void BasicMCTSPlayer<Board>::prepareTree(const GameState& state) {
+    if (!tree) {
+        capacity = static_cast<int>(min<size_t>(max<size_t>(treeBytes / (2 * sizeof(TreeNode)), 1024), INT_MAX / 2));
+        tree.reset(new TreeNode[capacity]);
+        spareTree.reset(new TreeNode[capacity]);
+        hasTree = false;
+    }
+    
+    const Board& target = state.getBoard();
+    int index = hasTree ? findNode(0, rootBoard, rootPlayer, target) : -1;
+    if (index > 0) {
+        compactTree(index);
+    } else if (index == -1) {
+        initNode(tree[0], 0, -1);
+        nodeCount = 1;
+    }
+    reusedNodes = (index == -1) ? 0 : min(nodeCount.load(), capacity);
+    treeFull = nodeCount >= capacity;
+    
+    rootBoard = target;
+    rootPlayer = sideToMove(state);
+    hasTree = true;
+    
+    // Expand the root now so a forced move shows before searching
+    TreeNode& root = tree[0];
+    if (root.firstChild == UNEXPANDED) {
+        root.firstChild = EXPANDING;
+        if (!expand(root, target.getXStones(), target.getMask(), rootPlayer)) {
+            root.firstChild = UNEXPANDED;
+        }
+    }
+}
+
+template <class Board>
+int BasicMCTSPlayer<Board>::findNode(int index, const Board& board, char player, const Board& target) const {
+    if (board == target) {
+        return index;
+    }
+    
+    const TreeNode& node = tree[index];
+    int first = node.firstChild;
+    if (first < 0) {
+        return -1;
+    }
+    for (int i = first; i < first + node.childCount; i++) {
+        // Only follow children whose stones are all in the target position
+        Board child = board;
+        child.play(tree[i].move, player);
+        Word outside = child.getMask() & ~target.getMask();
+        if (outside == 0 && (child.getXStones() ^ (target.getXStones() & child.getMask())) == 0) {
+            int found = findNode(i, child, otherPlayer(player), target);
+            if (found != -1) {
+                return found;
+            }
+        }
+    }
+    return -1;
+}
+
+template <class Board>
+void BasicMCTSPlayer<Board>::compactTree(int index) {
+    // Copy breadth first, so every copied family is placed together; until
+    // a copy's children are placed, its firstChild still holds the old index
+    TreeNode* to = spareTree.get();
+    int count = 0;
+    auto copy = [&](const TreeNode& from) {
+        TreeNode& node = to[count++];
+        node.visits.store(from.visits.load());
+        node.reward.store(from.reward.load());
+        node.firstChild.store(from.firstChild.load());
+        node.childCount = from.childCount;
+        node.move = from.move;
+        node.result = from.result;
+    };
+    
+    copy(tree[index]);
+    for (int next = 0; next < count; next++) {
+        int oldFirst = to[next].firstChild;
+        if (oldFirst < 0) {
+            continue;
+        }
+        to[next].firstChild = count;
+        for (int i = 0; i < to[next].childCount; i++) {
+            copy(tree[oldFirst + i]);
+        }
+    }
+    
+    swap(tree, spareTree);
+    nodeCount = count;
+}
+
+template <class Board>
+void BasicMCTSPlayer<Board>::initNode(TreeNode& node, int move, int result) {
+    node.visits = 0;
+    node.reward = 0;
+    node.firstChild = UNEXPANDED;
+    node.childCount = 0;
+    node.move = static_cast<uint8_t>(move);
+    node.result = static_cast<int8_t>(result);
+}
+
+template <class Board>
+bool BasicMCTSPlayer<Board>::expand(TreeNode& node, Word xStones, Word mask, char player) {
+    Word own = (player == 'X') ? xStones : xStones ^ mask;
+    Word playable = Board::playableCells(mask);
+    Word wins = Board::winningCells(own, mask) & playable;
+    Word blocks = Board::winningCells(own ^ mask, mask) & playable;
+    
+    // A winning move makes the others pointless, and so does a threat that
+    // must be blocked (with two threats every move loses anyway)
+    Word moves = wins ? Word(1) << lowestBit(wins) : blocks ? Word(1) << lowestBit(blocks) : playable;
+    int count = popCount(moves);
+    if (treeFull) {
+        return false;
+    }
+    int first = nodeCount.fetch_add(count);
+    if (first + count > capacity) {
+        treeFull = true;
+        return false;
+    }
+    
+    // Children from the centre outwards, so the first playouts go there
+    int child = first;
+    for (int i = 0; i < Board::WIDTH; i++) {
+        int col = Board::WIDTH / 2 + (i % 2 ? -(i + 1) / 2 : i / 2);
+        Word move = moves & Board::columnMask(col);
+        if (!move) {
+            continue;
+        }
+        int result = Board::hasAlignment(own | move) ? 2 : ((mask | move) == Board::boardMask() ? 1 : -1);
+        initNode(tree[child++], col, result);
+    }
+    
+    node.childCount = static_cast<uint8_t>(count);
+    node.firstChild.store(first, memory_order_release);
+    return true;
+}
+
+template <class Board>
+int BasicMCTSPlayer<Board>::selectChild(const TreeNode& node) const {
+    int first = node.firstChild.load(memory_order_acquire);
+    double logVisits = log(static_cast<double>(max(node.visits.load(memory_order_relaxed), 1)));
+    
+    // UCB1: average result plus an exploration bonus; unvisited children first
+    int best = first;
+    double bestValue = -1.0;
+    for (int i = first; i < first + node.childCount; i++) {
+        int visits = tree[i].visits.load(memory_order_relaxed);
+        if (visits == 0) {
+            return i;
+        }
+        double value = tree[i].reward.load(memory_order_relaxed) / (2.0 * visits) +
+                       exploration * sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = i;
+        }
+    }
+    return best;
+}
+
+template <class Board>
+void BasicMCTSPlayer<Board>::runSearch(long long playouts, bool timed, chrono::steady_clock::time_point deadline,
+                                       long long& done, int& depth) {
+    atomic<long long> started(0);
+    vector<long long> threadDone(threadCount, 0);
+    vector<int> threadDepth(threadCount, 0);
+    randomSeed = nextRandom(randomSeed);
+    
+    vector<thread> workers;
+    for (int i = 1; i < threadCount; i++) {
+        workers.push_back(thread(&BasicMCTSPlayer::searchThread, this, i, playouts, timed, deadline,
+                                 ref(started), ref(threadDone[i]), ref(threadDepth[i])));
+    }
+    searchThread(0, playouts, timed, deadline, started, threadDone[0], threadDepth[0]);
+    for (thread& t : workers) {
+        t.join();
+    }
+    
+    for (int i = 0; i < threadCount; i++) {
+        done += threadDone[i];
+        depth = max(depth, threadDepth[i]);
+    }
+}
+
+template <class Board>
+void BasicMCTSPlayer<Board>::searchThread(int threadId, long long playouts, bool timed,
+                                          chrono::steady_clock::time_point deadline, atomic<long long>& started,
+                                          long long& done, int& depth) {
+    uint64_t random = randomSeed ^ (static_cast<uint64_t>(threadId) << 32);
+    
+    // The clock is read every 64 iterations, after at least one
+    for (long long n = 0; !stopSearch && !stopRequested && started++ < playouts; n++) {
+        if (timed && n % 64 == 63 && chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        depth = max(depth, iterate(random));
+        done++;
+    }
+}
+
+template <class Board>
+int BasicMCTSPlayer<Board>::iterate(uint64_t& random) {
+    int path[MAX_PLY + 1];
+    int length = 0;
+    Word xStones = rootBoard.getXStones();
+    Word mask = rootBoard.getMask();
+    char player = rootPlayer;
+    
+    // Walk down, counting the visit of every node on the way
+    int index = 0;
+    tree[0].visits++;
+    path[length++] = 0;
+    char winner;
+    while (true) {
+        TreeNode& node = tree[index];
+        if (node.result >= 0) {
+            winner = (node.result == 2) ? otherPlayer(player) : ' ';
+            break;
+        }
+        
+        // Expand a node on its second visit; only the thread that claims it
+        // does, the others play out from it meanwhile
+        int first = node.firstChild.load(memory_order_acquire);
+        if (first == UNEXPANDED && node.visits.load(memory_order_relaxed) > 1) {
+            int expected = UNEXPANDED;
+            if (node.firstChild.compare_exchange_strong(expected, EXPANDING) && !expand(node, xStones, mask, player)) {
+                node.firstChild = UNEXPANDED;
+            }
+            first = node.firstChild.load(memory_order_acquire);
+        }
+        if (first < 0) {
+            winner = playout(xStones, mask, player, random);
+            break;
+        }
+        
+        index = selectChild(node);
+        Word move = Board::playableCells(mask) & Board::columnMask(tree[index].move);
+        mask |= move;
+        if (player == 'X') {
+            xStones |= move;
+        }
+        player = otherPlayer(player);
+        tree[index].visits++;
+        path[length++] = index;
+    }
+    
+    // Credit every node with the result for the player who moved into it
+    char mover = otherPlayer(rootPlayer);
+    for (int i = 0; i < length; i++) {
+        tree[path[i]].reward += (winner == mover) ? 2 : (winner == ' ' ? 1 : 0);
+        mover = otherPlayer(mover);
+    }
+    return length - 1;
+}
+
+template <class Board>
+char BasicMCTSPlayer<Board>::playout(Word xStones, Word mask, char player, uint64_t& random) const {
+    while (mask != Board::boardMask()) {
+        Word own = (player == 'X') ? xStones : xStones ^ mask;
+        Word playable = Board::playableCells(mask);
+        Word move;
+        if (heavyPlayouts) {
+            if (Board::winningCells(own, mask) & playable) {
+                return player;
+            }
+            
+            // Block a threat, otherwise avoid the cells right below one
+            Word threats = Board::winningCells(own ^ mask, mask);
+            Word safe = playable & ~(threats >> 1);
+            if (threats & playable) {
+                move = Word(1) << lowestBit(threats & playable);
+            } else {
+                move = randomBit(safe ? safe : playable, random);
+            }
+        } else {
+            move = randomBit(playable, random);
+            if (Board::hasAlignment(own | move)) {
+                return player;
+            }
+        }
+        
+        mask |= move;
+        if (player == 'X') {
+            xStones |= move;
+        }
+        player = otherPlayer(player);
+    }
+    return ' ';
+}
+
+template <class Board>
+int BasicMCTSPlayer<Board>::bestChild(int index) const {
+    const TreeNode& node = tree[index];
+    int first = node.firstChild;
+    if (first < 0) {
+        return -1;
+    }
+    
+    int best = first;
+    for (int i = first + 1; i < first + node.childCount; i++) {
+        if (tree[i].visits > tree[best].visits ||
+            (tree[i].visits == tree[best].visits && tree[i].reward > tree[best].reward)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+template <class Board>
+void BasicMCTSPlayer<Board>::startPondering(const GameState& state) {
+    stopPondering();
+    if (state.isWinningState() || state.isDrawState()) {
+        return;
+    }
+    
+    // The flag is cleared here rather than in the thread, so a stop
+    // requested right after starting cannot be lost
+    stopSearch = false;
+    ponderThread = thread(&BasicMCTSPlayer::ponder, this, state);
+}
+
+template <class Board>
+void BasicMCTSPlayer<Board>::stopPondering() {
+    if (ponderThread.joinable()) {
+        stopSearch = true;
+        ponderThread.join();
+        stopSearch = false;
+    }
+}
+
+template <class Board>
+void BasicMCTSPlayer<Board>::ponder(GameState state) {
+    prepareTree(state);
+    long long done = 0;
+    int depth = 0;
+    runSearch(LLONG_MAX, false, chrono::steady_clock::time_point(), done, depth);
+}
+
+template class BasicMCTSPlayer<Bitboard>;
+template class BasicMCTSPlayer<Bitboard8x7>;
+template class BasicMCTSPlayer<Bitboard9x7>;
+template class BasicMCTSPlayer<Bitboard9x6Connect5>;
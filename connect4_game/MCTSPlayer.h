@@ -0,0 +1,194 @@
+#ifndef MCTSPLAYER_H
+#define MCTSPLAYER_H
+
+#include "Engine.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace std;
+
+// Monte Carlo tree search player (UCT), for any board variant.
+//
+// Every iteration walks down the tree choosing children by the UCB1 bound,
+// expands the leaf once it has been visited before, finishes the game from
+// there with a playout on the bare bitboard masks and adds the result to
+// every node on the path. Heavy playouts (the default) take an immediate
+// win, block the opponent's immediate win and avoid playing under it;
+// light playouts move at random. A node with a winning move only gets that
+// child, and a node facing an immediate loss only the blocking one.
+//
+// The nodes live in one flat pool, the children of a node side by side.
+// After a search the tree is kept, and the next search that starts from a
+// position below the old root (after the engine's move and the reply, or
+// after pondering) copies that subtree into a second pool and continues it.
+//
+// Search threads share the tree without locks: a thread counts its visit on
+// the way down and adds the result on the way up, so a path with playouts
+// still running scores as a loss to the other threads (virtual loss) and
+// they spread over different lines.
+template <class Board>
+class BasicMCTSPlayer : public BasicEngine<Board> {
+public:
+    typedef BasicGameState<Board> GameState;
+
+private:
+    typedef typename Board::Word Word;
+    
+    static const int MAX_PLY = Board::WIDTH * Board::HEIGHT;
+    
+    // Markers in TreeNode::firstChild
+    static const int UNEXPANDED = -1;
+    static const int EXPANDING = -2;
+    
+    // One tree node; rewards are half points (win 2, draw 1) of the player
+    // who made the move leading to the node
+    struct TreeNode {
+        atomic<int> visits;      // Including the playouts still running
+        atomic<int> reward;
+        atomic<int> firstChild;  // Pool index of the first child, or a marker
+        uint8_t childCount;
+        uint8_t move;            // Column played to reach the node
+        int8_t result;           // Reward of a finished game, -1 if it goes on
+    };
+    
+    char playerSymbol;
+    long long maxPlayouts;
+    size_t treeBytes;
+    int threadCount;
+    double exploration;
+    bool heavyPlayouts;
+    uint64_t randomSeed;
+    shared_ptr<const OpeningBook> openingBook;
+    
+    // The tree and the pool its reused part is copied into; allocated by the
+    // first search
+    unique_ptr<TreeNode[]> tree;
+    unique_ptr<TreeNode[]> spareTree;
+    int capacity;
+    atomic<int> nodeCount;
+    atomic<bool> treeFull;
+    
+    // Position of the root (node 0) and the player to move there
+    Board rootBoard;
+    char rootPlayer;
+    bool hasTree;
+    int reusedNodes;
+    
+    // stopSearch ends pondering, stopRequested is only set by stop()
+    atomic<bool> stopSearch;
+    atomic<bool> stopRequested;
+    SearchStats lastStats;
+    thread ponderThread;
+    
+    // Make node 0 the root for a position and expand it, keeping the subtree
+    // of an earlier search that contains the position
+    void prepareTree(const GameState& state);
+    
+    // Node below index (reached in board, player to move) for a position,
+    // or -1 if it is not in the tree
+    int findNode(int index, const Board& board, char player, const Board& target) const;
+    
+    // Copy the subtree below index into the spare pool and swap the pools
+    void compactTree(int index);
+    
+    // Reset a node with no visits
+    void initNode(TreeNode& node, int move, int result);
+    
+    // Create the children of a node claimed for expansion; returns false if
+    // the pool is full
+    bool expand(TreeNode& node, Word xStones, Word mask, char player);
+    
+    // Child of a node to descend into
+    int selectChild(const TreeNode& node) const;
+    
+    // Search a position until the playout budget, the deadline or stop()
+    int search(const GameState& state, long long playouts, bool timed, chrono::steady_clock::time_point deadline);
+    
+    // Run iterations on all threads; adds the playouts done and the length
+    // of the longest path
+    void runSearch(long long playouts, bool timed, chrono::steady_clock::time_point deadline, long long& done, int& depth);
+    void searchThread(int threadId, long long playouts, bool timed, chrono::steady_clock::time_point deadline,
+                      atomic<long long>& started, long long& done, int& depth);
+    
+    // One iteration from the root; returns the length of its path
+    int iterate(uint64_t& random);
+    
+    // Finish a game from a position; returns the winner or ' ' for a draw
+    char playout(Word xStones, Word mask, char player, uint64_t& random) const;
+    
+    // Grow the tree of a position until stopped
+    void ponder(GameState state);
+    
+    // Most visited child of a node, or -1 if it has none
+    int bestChild(int index) const;
+    
+    // Book move for the player to move, or -1
+    int findBookMove(const GameState& state) const;
+    
+    char sideToMove(const GameState& state) const {
+        return state.getLastPlayer() == 'X' ? 'O' : 'X';
+    }
+
+public:
+    // Constructor
+    BasicMCTSPlayer(char symbol, long long playouts = 20000, size_t treeSizeMB = 32, int threads = 1);
+    
+    // Destructor
+    ~BasicMCTSPlayer();
+    
+    // Best move after the playout budget
+    int getBestMove(const GameState& currentState) override;
+    
+    // Best move after searching for a time budget
+    int getBestMove(const GameState& currentState, chrono::milliseconds timeBudget) override;
+    
+    // Interrupt the running search from another thread; it returns the best
+    // move found so far. The request also ends searches started later,
+    // until clearStop() is called.
+    void stop() override { stopRequested = true; }
+    void clearStop() override { stopRequested = false; }
+    
+    // Grow the tree of the opponent's position in the background; the next
+    // search reuses the part below the opponent's move
+    void startPondering(const GameState& state) override;
+    void stopPondering() override;
+    bool isPondering() const { return ponderThread.joinable(); }
+    
+    // Number of search threads sharing the tree
+    void setThreads(int threads) override { threadCount = max(threads, 1); }
+    int getThreads() const { return threadCount; }
+    
+    // Opening book consulted before searching; books only exist for the
+    // standard board and are ignored on other variants
+    void setOpeningBook(shared_ptr<const OpeningBook> book) override { openingBook = book; }
+    
+    // Drop the tree
+    void newGame() override { hasTree = false; }
+    
+    // Playouts of getBestMove without a time budget
+    void setPlayouts(long long playouts) { maxPlayouts = max(playouts, 1LL); }
+    
+    // Memory of the two node pools; drops the tree
+    void setTreeSize(size_t sizeMB);
+    
+    // Exploration constant of the UCB1 bound
+    void setExploration(double constant) { exploration = constant; }
+    
+    // Heavy (tactical) or light (uniformly random) playouts
+    void setHeavyPlayouts(bool enabled) { heavyPlayouts = enabled; }
+    
+    // Statistics of the last search: nodes counts playouts, depth is the
+    // longest path in the tree and score the expected result of the best
+    // move from -1000 (lost) to 1000 (won)
+    const SearchStats& getLastStats() const override { return lastStats; }
+    
+    // Nodes kept from the previous search and nodes in the tree now
+    int getReusedNodes() const { return reusedNodes; }
+    int getTreeNodes() const { return hasTree ? min(nodeCount.load(), capacity) : 0; }
+};
+
+typedef BasicMCTSPlayer<Bitboard> MCTSPlayer;
+
+#endif
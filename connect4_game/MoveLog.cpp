@@ -0,0 +1,34 @@
+#include "MoveLog.h"
+
+void MoveLog::record(int col) {
+    moves.resize(current);
+    moves.push_back(static_cast<uint8_t>(col));
+    current++;
+}
+
+int MoveLog::undo() {
+    if (!canUndo()) {
+        return -1;
+    }
+    return moves[--current];
+}
+
+int MoveLog::redo() {
+    if (!canRedo()) {
+        return -1;
+    }
+    return moves[current++];
+}
+
+void MoveLog::clear() {
+    moves.clear();
+    current = 0;
+}
+
+string MoveLog::toString() const {
+    string text;
+    for (size_t ply = 0; ply < current; ply++) {
+        text += static_cast<char>('1' + moves[ply]);
+    }
+    return text;
+}
@@ -0,0 +1,49 @@
+#ifndef MOVELOG_H
+#define MOVELOG_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Moves of one game in the order they were played, one byte per ply.
+// A cursor marks the current position: undo and redo only move the cursor,
+// so undone moves stay in the log until a different move is recorded in
+// their place. Positions are not stored; replay the moves to rebuild one.
+class MoveLog {
+private:
+    vector<uint8_t> moves;   // Columns played, including undone moves that can be redone
+    size_t current;          // Number of moves leading to the current position
+
+public:
+    // Constructor
+    MoveLog() : current(0) {}
+    
+    // Append a move after the current position, forgetting any undone moves
+    void record(int col);
+    
+    // Step back or forward one move; return the column of that move, or -1
+    // at either end of the log
+    int undo();
+    int redo();
+    
+    bool canUndo() const { return current > 0; }
+    bool canRedo() const { return current < moves.size(); }
+    
+    // Number of moves up to the current position, and the column of each
+    size_t size() const { return current; }
+    int moveAt(size_t ply) const { return moves[ply]; }
+    
+    // Column of the last move up to the current position, -1 if there is none
+    int lastMove() const { return current > 0 ? moves[current - 1] : -1; }
+    
+    // Forget every move
+    void clear();
+    
+    // Moves up to the current position as columns from 1, e.g. "4453"
+    string toString() const;
+};
+
+#endif
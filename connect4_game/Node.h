@@ -1,6 +1,8 @@
 #ifndef NODE_H
 #define NODE_H
 
+#include "Bitboard.h"
+#include "Evaluator.h"
 #include <vector>
 
 using namespace std;
@@ -31,46 +33,39 @@ public:
     void setPrev(Node<T>* node) { prev = node; }
 };
 
-// GameState class to represent a board state
-class GameState {
+// GameState class to represent a board state, for any board variant
+template <class Board>
+class BasicGameState {
 private:
-    vector<vector<char>> board;
+    typedef BasicEvaluator<Board> Evaluator;
+    
+    Board board;
     int lastMoveRow;
     int lastMoveCol;
     char lastPlayer;
     int depth;
     int score;
+    int heuristic;  // Window evaluation of the board, kept up to date by makeMove
+    
+    // Constructor for a successor whose heuristic was updated incrementally
+    BasicGameState(const Board& b, int row, int col, char player, int d, int s, int h)
+        : board(b), lastMoveRow(row), lastMoveCol(col), lastPlayer(player), depth(d), score(s), heuristic(h) {}
 
 public:
     // Constructor
-    GameState(const vector<vector<char>>& b, int row = -1, int col = -1, char player = ' ', int d = 0, int s = 0)
-        : board(b), lastMoveRow(row), lastMoveCol(col), lastPlayer(player), depth(d), score(s) {}
-    
-    // Copy constructor
-    GameState(const GameState& other)
-        : board(other.board), lastMoveRow(other.lastMoveRow), lastMoveCol(other.lastMoveCol),
-          lastPlayer(other.lastPlayer), depth(other.depth), score(other.score) {}
-    
-    // Assignment operator
-    GameState& operator=(const GameState& other) {
-        if (this != &other) {
-            board = other.board;
-            lastMoveRow = other.lastMoveRow;
-            lastMoveCol = other.lastMoveCol;
-            lastPlayer = other.lastPlayer;
-            depth = other.depth;
-            score = other.score;
-        }
-        return *this;
-    }
+    BasicGameState(const Board& b = Board(), int row = -1, int col = -1, char player = ' ', int d = 0, int s = 0)
+        : board(b), lastMoveRow(row), lastMoveCol(col), lastPlayer(player), depth(d), score(s),
+          heuristic(Evaluator::evaluate(b)) {}
     
     // Getters
-    vector<vector<char>> getBoard() const { return board; }
+    const Board& getBoard() const { return board; }
+    char getCell(int row, int col) const { return board.cellAt(row, col); }
     int getLastMoveRow() const { return lastMoveRow; }
     int getLastMoveCol() const { return lastMoveCol; }
     char getLastPlayer() const { return lastPlayer; }
     int getDepth() const { return depth; }
     int getScore() const { return score; }
+    int getHeuristic() const { return heuristic; }
     
     // Setters
     void setScore(int s) { score = s; }
@@ -86,13 +81,13 @@ public:
     int evaluateState() const;
     
     // Generate all possible next states
-    vector<GameState> generateNextStates(char player) const;
+    vector<BasicGameState> generateNextStates(char player) const;
     
     // Check if a move is valid
     bool isValidMove(int col) const;
     
     // Make a move and return new state
-    GameState makeMove(int col, char player) const;
+    BasicGameState makeMove(int col, char player) const;
     
     // Check for win condition
     bool checkWin(int row, int col) const;
@@ -101,4 +96,6 @@ public:
     bool checkDiagonal(int row, int col) const;
 };
 
+typedef BasicGameState<Bitboard> GameState;
+
 #endif
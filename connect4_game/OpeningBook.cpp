@@ -0,0 +1,159 @@
+#include "OpeningBook.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[8] = { 'C', '4', 'B', 'O', 'O', 'K', 0, 0 };
+const int KEY_SHIFT = 15;
+
+uint64_t packEntry(const OpeningBook::Entry& entry) {
+    int score = max(OpeningBook::MIN_SCORE, min(OpeningBook::MAX_SCORE, entry.score));
+    return entry.key << KEY_SHIFT |
+           static_cast<uint64_t>(entry.move & 0x7) << 12 |
+           static_cast<uint64_t>(score & 0xFFF);
+}
+
+// Book files are little-endian; other hosts swap the bytes of every field
+uint32_t littleEndian(uint32_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return __builtin_bswap32(value);
+#else
+    return value;
+#endif
+}
+
+uint64_t littleEndian(uint64_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return __builtin_bswap64(value);
+#else
+    return value;
+#endif
+}
+
+int unpackScore(uint64_t packed) {
+    int score = static_cast<int>(packed & 0xFFF);
+    return score >= 2048 ? score - 4096 : score;
+}
+
+}
+
+OpeningBook::OpeningBook() : mapping(nullptr), mappingSize(0), header(), entries(nullptr) {}
+
+OpeningBook::~OpeningBook() {
+    close();
+}
+
+bool OpeningBook::load(const string& path) {
+    close();
+    
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    
+    size_t length = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    
+    // Validate the header before exposing the entries
+    Header h;
+    memcpy(&h, data, sizeof(Header));
+    h.version = littleEndian(h.version);
+    h.maxPly = littleEndian(h.maxPly);
+    h.entryCount = littleEndian(h.entryCount);
+    h.flags = littleEndian(h.flags);
+    if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != VERSION ||
+        h.entryCount > (length - sizeof(Header)) / sizeof(uint64_t)) {
+        munmap(data, length);
+        return false;
+    }
+    
+    mapping = data;
+    mappingSize = length;
+    header = h;
+    entries = reinterpret_cast<const uint64_t*>(static_cast<const char*>(data) + sizeof(Header));
+    return true;
+}
+
+void OpeningBook::close() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    header = Header();
+    entries = nullptr;
+}
+
+int OpeningBook::lookup(const Bitboard& board, int* score) const {
+    if (!entries || board.getMoveCount() > static_cast<int>(header.maxPly)) {
+        return -1;
+    }
+    
+    // Binary search on the key bits of the sorted entries
+    uint64_t key = board.canonicalKey();
+    const uint64_t* first = entries;
+    const uint64_t* last = entries + header.entryCount;
+    const uint64_t* it = lower_bound(first, last, key << KEY_SHIFT,
+                                     [](uint64_t entry, uint64_t value) { return littleEndian(entry) < value; });
+    if (it == last || (littleEndian(*it) >> KEY_SHIFT) != key) {
+        return -1;
+    }
+    
+    uint64_t entry = littleEndian(*it);
+    int move = static_cast<int>((entry >> 12) & 0x7);
+    if (board.isMirroredCanonical()) {
+        move = Bitboard::WIDTH - 1 - move;
+    }
+    if (score) {
+        *score = unpackScore(entry);
+    }
+    return move;
+}
+
+bool OpeningBook::write(const string& path, const vector<Entry>& positions, int maxPly, uint64_t flags) {
+    vector<uint64_t> packed;
+    packed.reserve(positions.size());
+    for (const Entry& entry : positions) {
+        packed.push_back(packEntry(entry));
+    }
+    
+    // Sort by key and keep a single entry per position
+    sort(packed.begin(), packed.end());
+    packed.erase(unique(packed.begin(), packed.end(),
+                        [](uint64_t a, uint64_t b) { return (a >> KEY_SHIFT) == (b >> KEY_SHIFT); }),
+                 packed.end());
+    
+    Header h;
+    memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = littleEndian(VERSION);
+    h.maxPly = littleEndian(static_cast<uint32_t>(maxPly));
+    h.entryCount = littleEndian(static_cast<uint64_t>(packed.size()));
+    h.flags = littleEndian(flags);
+    for (uint64_t& entry : packed) {
+        entry = littleEndian(entry);
+    }
+    
+    ofstream out(path.c_str(), ios::binary | ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(packed.data()), packed.size() * sizeof(uint64_t));
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,84 @@
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include "Bitboard.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Precomputed opening moves stored in a compact sorted binary file.
+//
+// File layout (little-endian; hosts of the other byte order convert every
+// field as they write or read it):
+//   header   magic "C4BOOK\0\0", uint32 version, uint32 max ply,
+//            uint64 entry count, uint64 flags
+//   entries  one uint64 per position, sorted ascending:
+//            canonical key << 15 | best move << 12 | (score & 0xFFF)
+//
+// Positions are stored once for a board and its mirror image, using
+// Bitboard::canonicalKey(); the move is given for the canonical orientation.
+// The file is mapped read-only with mmap and searched in place, so loading
+// a book does not parse anything.
+class OpeningBook {
+public:
+    static const uint32_t VERSION = 1;
+    static const uint64_t FLAG_EXACT_SCORES = 1;  // Scores come from the perfect-play solver
+    static const int MIN_SCORE = -2048;
+    static const int MAX_SCORE = 2047;
+    
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t maxPly;
+        uint64_t entryCount;
+        uint64_t flags;
+    };
+    
+    // One book position before packing
+    struct Entry {
+        uint64_t key;  // Canonical key of the position
+        int move;      // Best column in the canonical orientation
+        int score;     // Score for the player to move
+    };
+
+private:
+    void* mapping;
+    size_t mappingSize;
+    Header header;              // Copy of the file header in host byte order
+    const uint64_t* entries;    // Mapped entries, little-endian
+    
+    // A mapped book cannot be copied
+    OpeningBook(const OpeningBook&);
+    OpeningBook& operator=(const OpeningBook&);
+
+public:
+    // Constructor
+    OpeningBook();
+    
+    // Destructor
+    ~OpeningBook();
+    
+    // Map a book file; returns false if it is missing or malformed
+    bool load(const string& path);
+    
+    // Unmap the current book
+    void close();
+    
+    // Best move for a position, or -1 if it is not in the book;
+    // the stored score is written to score when requested
+    int lookup(const Bitboard& board, int* score = nullptr) const;
+    
+    // Book information
+    bool isLoaded() const { return entries != nullptr; }
+    size_t size() const { return entries ? header.entryCount : 0; }
+    int getMaxPly() const { return entries ? static_cast<int>(header.maxPly) : 0; }
+    bool hasExactScores() const { return entries && (header.flags & FLAG_EXACT_SCORES); }
+    
+    // Sort, deduplicate and write a book file
+    static bool write(const string& path, const vector<Entry>& positions, int maxPly, uint64_t flags);
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef SEARCHPOSITION_H
+#define SEARCHPOSITION_H
+
+#include "Node.h"
+
+using namespace std;
+
+// Mutable position used inside the search.
+// Moves are made and taken back in place with play/undo; a fixed-size move
+// stack remembers what is needed to undo them, so searching a node never
+// copies the board or touches the heap.
+template <class Board>
+class BasicSearchPosition {
+public:
+    typedef typename Board::Word Word;
+    static const int MAX_MOVES = Board::WIDTH * Board::HEIGHT;
+
+private:
+    Board board;
+    int heuristic;
+    int ply;
+    
+    // Undo information per ply
+    int8_t moveStack[MAX_MOVES];
+    char playerStack[MAX_MOVES];
+    int heuristicStack[MAX_MOVES];
+    
+    // Last move of the position the search started from
+    char rootLastPlayer;
+    bool rootHasLastMove;
+
+public:
+    // Constructor
+    explicit BasicSearchPosition(const BasicGameState<Board>& state)
+        : board(state.getBoard()), heuristic(state.getHeuristic()), ply(0),
+          rootLastPlayer(state.getLastPlayer()),
+          rootHasLastMove(state.getLastMoveRow() != -1 && state.getLastMoveCol() != -1) {}
+    
+    // Getters
+    const Board& getBoard() const { return board; }
+    uint64_t getHash() const { return board.getHash(); }
+    int getPly() const { return ply; }
+    int getHeuristic() const { return heuristic; }
+    
+    char getLastPlayer() const {
+        return ply > 0 ? playerStack[ply - 1] : rootLastPlayer;
+    }
+    
+    int getLastMove() const {
+        return ply > 0 ? moveStack[ply - 1] : -1;
+    }
+    
+    // Check if a move is valid
+    bool canPlay(int col) const {
+        return col >= 0 && col < Board::WIDTH && board.canPlay(col);
+    }
+    
+    // Cell a piece dropped into the column would occupy
+    Word moveMask(int col) const {
+        return Board::playableCells(board.getMask()) & Board::columnMask(col);
+    }
+    
+    // Drop a piece for the given player
+    void play(int col, char player) {
+        moveStack[ply] = static_cast<int8_t>(col);
+        playerStack[ply] = player;
+        heuristicStack[ply] = heuristic;
+        ply++;
+        
+        heuristic += BasicEvaluator<Board>::moveDelta(board, moveMask(col), player);
+        board.play(col, player);
+    }
+    
+    // Take back the last move
+    void undo() {
+        ply--;
+        board.unplay(moveStack[ply]);
+        heuristic = heuristicStack[ply];
+    }
+    
+    // Check if the last move completed four in a row
+    bool isWinningState() const {
+        if (ply == 0 && !rootHasLastMove) return false;
+        char player = getLastPlayer();
+        return player != ' ' && Board::hasAlignment(board.stones(player));
+    }
+    
+    // Check if the board is full without a winner
+    bool isDrawState() const {
+        return board.isFull() && !isWinningState();
+    }
+    
+    // Same scoring as GameState::evaluateState
+    int evaluateState() const {
+        if (isWinningState()) {
+            return (getLastPlayer() == 'O') ? 1000 : -1000;
+        }
+        if (isDrawState()) {
+            return 0;
+        }
+        return heuristic;
+    }
+};
+
+typedef BasicSearchPosition<Bitboard> SearchPosition;
+
+#endif
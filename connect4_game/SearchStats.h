@@ -0,0 +1,109 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include "Bitboard.h"
+#include <vector>
+#include <string>
+#include <ostream>
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+
+// Work done by one search: counters are summed over all search threads,
+// the remaining fields describe the deepest completed iteration
+struct SearchStats {
+    // Longest game on the largest board variant, plus one
+    static const int MAX_PLY = Bitboard9x7::WIDTH * Bitboard9x7::HEIGHT + 1;
+    
+    long long nodes;
+    long long nodesPerPly[MAX_PLY + 1];  // Index 1 holds the replies to the root moves
+    long long cutoffs;
+    long long firstMoveCutoffs;          // Cutoffs caused by the first move searched
+    long long tableProbes;
+    long long tableHits;
+    long long evaluations;               // Leaf positions scored
+    long long threatProofs;              // Positions proven lost by the threat analysis
+    
+    int depth;                           // 0 when the move was found without a search
+    int score;                           // From the searching player's view
+    int bestMove;
+    vector<int> principalVariation;      // Best line, starting with bestMove
+    double elapsedMs;
+    
+    SearchStats() { reset(); }
+    
+    void reset() {
+        nodes = cutoffs = firstMoveCutoffs = tableProbes = tableHits = evaluations = threatProofs = 0;
+        for (int i = 0; i <= MAX_PLY; i++) {
+            nodesPerPly[i] = 0;
+        }
+        depth = score = 0;
+        bestMove = -1;
+        principalVariation.clear();
+        elapsedMs = 0.0;
+    }
+    
+    // Add the counters of another thread
+    void merge(const SearchStats& other) {
+        nodes += other.nodes;
+        cutoffs += other.cutoffs;
+        firstMoveCutoffs += other.firstMoveCutoffs;
+        tableProbes += other.tableProbes;
+        tableHits += other.tableHits;
+        evaluations += other.evaluations;
+        threatProofs += other.threatProofs;
+        for (int i = 0; i <= MAX_PLY; i++) {
+            nodesPerPly[i] += other.nodesPerPly[i];
+        }
+    }
+    
+    double firstMoveCutoffRate() const {
+        return cutoffs > 0 ? static_cast<double>(firstMoveCutoffs) / cutoffs : 0.0;
+    }
+    
+    double tableHitRate() const {
+        return tableProbes > 0 ? static_cast<double>(tableHits) / tableProbes : 0.0;
+    }
+};
+
+// Receives the statistics of every completed search iteration.
+// Calls are compiled in only when SEARCH_TRACE is defined (make trace), so a
+// normal build pays nothing for tracing, not even for collecting the data.
+class SearchTraceSink {
+public:
+    virtual ~SearchTraceSink() {}
+    virtual void onIteration(const SearchStats& stats) = 0;
+};
+
+// Writes one line per iteration to a stream
+class StreamTraceSink : public SearchTraceSink {
+private:
+    ostream& out;
+
+public:
+    explicit StreamTraceSink(ostream& stream) : out(stream) {}
+    
+    void onIteration(const SearchStats& stats) override {
+        ostringstream line;
+        line << "info depth " << stats.depth << " score " << stats.score << " nodes " << stats.nodes
+             << " time " << fixed << setprecision(1) << stats.elapsedMs
+             << " tthit " << setprecision(3) << stats.tableHitRate()
+             << " cut1st " << stats.firstMoveCutoffRate() << " evals " << stats.evaluations << " pv";
+        for (int move : stats.principalVariation) {
+            line << " " << move + 1;
+        }
+        line << "\n";
+        
+        // Format the line first so it reaches the stream in one piece
+        out << line.str() << flush;
+    }
+};
+
+#ifdef SEARCH_TRACE
+#define SEARCH_TRACE_ITERATION(sink, stats) do { if (sink) (sink)->onIteration(stats); } while (0)
+#else
+#define SEARCH_TRACE_ITERATION(sink, stats) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,297 @@
+#include "Solver.h"
+#include <algorithm>
+
+namespace {
+
+const int CELLS = Bitboard::WIDTH * Bitboard::HEIGHT;
+
+// Small insertion-sorted list of candidate moves, best score last
+class MoveSorter {
+private:
+    struct Entry {
+        uint64_t move;
+        int score;
+    };
+    Entry entries[Bitboard::WIDTH];
+    int size;
+
+public:
+    MoveSorter() : size(0) {}
+    
+    void add(uint64_t move, int score) {
+        int pos = size++;
+        for (; pos > 0 && entries[pos - 1].score > score; pos--) {
+            entries[pos] = entries[pos - 1];
+        }
+        entries[pos].move = move;
+        entries[pos].score = score;
+    }
+    
+    // Next best move, or 0 when the list is exhausted
+    uint64_t next() {
+        return size ? entries[--size].move : 0;
+    }
+};
+
+int columnOf(uint64_t move) {
+    return __builtin_ctzll(move) / Bitboard::COLUMN_BITS;
+}
+
+// Table moves are stored for the orientation the key was taken from
+int tableMove(int move, bool mirrored) {
+    return (move >= 0 && mirrored) ? Bitboard::WIDTH - 1 - move : move;
+}
+
+}
+
+Solver::Solver(size_t ttSizeMB) : transpositionTable(ttSizeMB), nodeCount(0) {
+    // Explore central columns first: 3, 2, 4, 1, 5, 0, 6
+    for (int i = 0; i < Bitboard::WIDTH; i++) {
+        columnOrder[i] = Bitboard::WIDTH / 2 + (1 - 2 * (i % 2)) * (i + 1) / 2;
+    }
+}
+
+void Solver::reset() {
+    transpositionTable.clear();
+    nodeCount = 0;
+}
+
+char Solver::sideToMove(const GameState& state) {
+    if (state.getLastPlayer() == 'X') return 'O';
+    if (state.getLastPlayer() == 'O') return 'X';
+    return (state.getBoard().getMoveCount() % 2 == 0) ? 'X' : 'O';
+}
+
+Solver::Position Solver::fromState(const GameState& state) {
+    const Bitboard& board = state.getBoard();
+    Position pos;
+    pos.current = board.stones(sideToMove(state));
+    pos.mask = board.getMask();
+    pos.moves = board.getMoveCount();
+    return pos;
+}
+
+uint64_t Solver::tableKey(uint64_t positionKey) {
+    // Mix the key so the low bits used for indexing are well distributed
+    // (the mix is a bijection)
+    uint64_t z = positionKey;
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+uint64_t Solver::possibleNonLosingMoves(const Position& pos) {
+    uint64_t possible = Bitboard::playableCells(pos.mask);
+    uint64_t opponentWin = Bitboard::winningCells(pos.opponent(), pos.mask);
+    uint64_t forced = possible & opponentWin;
+    
+    if (forced) {
+        // Two immediate threats cannot both be blocked
+        if (forced & (forced - 1)) {
+            return 0;
+        }
+        possible = forced;
+    }
+    
+    // Never play directly below a cell the opponent needs
+    return possible & ~(opponentWin >> 1);
+}
+
+int Solver::negamax(const Position& pos, int alpha, int beta) {
+    nodeCount++;
+    
+    uint64_t next = possibleNonLosingMoves(pos);
+    if (next == 0) {
+        return -(CELLS - pos.moves) / 2;
+    }
+    if (pos.moves >= CELLS - 2) {
+        return 0;
+    }
+    
+    // The opponent cannot win on their next move, which bounds the score from below
+    int min = -(CELLS - 2 - pos.moves) / 2;
+    if (alpha < min) {
+        alpha = min;
+        if (alpha >= beta) return alpha;
+    }
+    
+    // We cannot win on this move either, which bounds it from above
+    int max = (CELLS - 1 - pos.moves) / 2;
+    
+    // current + mask identifies the position uniquely, and a column's sum
+    // never carries into the next column, so mirroring it gives the key of
+    // the mirrored position. Both positions share the smaller key
+    uint64_t positionKey = pos.current + pos.mask;
+    uint64_t mirroredKey = Bitboard::mirror(positionKey);
+    bool mirrored = mirroredKey < positionKey;
+    uint64_t key = tableKey(mirrored ? mirroredKey : positionKey);
+    int ttMove = -1;
+    TTEntry entry;
+    if (transpositionTable.probe(key, entry)) {
+        ttMove = tableMove(entry.bestMove, mirrored);
+        if (entry.bound == BOUND_LOWER) {
+            if (alpha < entry.score) {
+                alpha = entry.score;
+                if (alpha >= beta) return alpha;
+            }
+        } else if (entry.bound == BOUND_UPPER) {
+            max = std::min(max, static_cast<int>(entry.score));
+        } else if (entry.bound == BOUND_EXACT) {
+            return entry.score;
+        }
+    }
+    
+    if (beta > max) {
+        beta = max;
+        if (alpha >= beta) return beta;
+    }
+    
+    // Order moves by the number of threats they create, centre first on ties,
+    // and try the move remembered in the table before everything else
+    MoveSorter moves;
+    for (int i = Bitboard::WIDTH - 1; i >= 0; i--) {
+        uint64_t move = next & Bitboard::columnMask(columnOrder[i]);
+        if (move) {
+            int score = __builtin_popcountll(Bitboard::winningCells(pos.current | move, pos.mask));
+            if (columnOrder[i] == ttMove) {
+                score = Bitboard::WIDTH * Bitboard::HEIGHT;
+            }
+            moves.add(move, score);
+        }
+    }
+    
+    int bestMove = -1;
+    while (uint64_t move = moves.next()) {
+        Position child = pos;
+        child.play(move);
+        int score = -negamax(child, -beta, -alpha);
+        
+        if (score >= beta) {
+            transpositionTable.store(key, CELLS - pos.moves, BOUND_LOWER, score, tableMove(columnOf(move), mirrored));
+            return score;
+        }
+        if (score > alpha) {
+            alpha = score;
+            bestMove = columnOf(move);
+        }
+    }
+    
+    // No move reached beta, so alpha is an upper bound on the score
+    transpositionTable.store(key, CELLS - pos.moves, BOUND_UPPER, alpha, tableMove(bestMove, mirrored));
+    return alpha;
+}
+
+int Solver::solvePosition(const Position& pos, bool weak) {
+    // Immediate win for the player to move
+    if (Bitboard::winningCells(pos.current, pos.mask) & Bitboard::playableCells(pos.mask)) {
+        return weak ? 1 : (CELLS + 1 - pos.moves) / 2;
+    }
+    
+    int min = -(CELLS - pos.moves) / 2;
+    int max = (CELLS + 1 - pos.moves) / 2;
+    if (weak) {
+        min = -1;
+        max = 1;
+    }
+    
+    // Narrow [min, max] with null-window searches, probing near zero first
+    // because most positions are close to a draw
+    while (min < max) {
+        int med = min + (max - min) / 2;
+        if (med <= 0 && min / 2 < med) {
+            med = min / 2;
+        } else if (med >= 0 && max / 2 > med) {
+            med = max / 2;
+        }
+        
+        int r = negamax(pos, med, med + 1);
+        
+        // A weak solve only keeps the sign; the search may fail outside [-1, 1]
+        if (weak) {
+            r = (r > 0) - (r < 0);
+        }
+        if (r <= med) {
+            max = r;
+        } else {
+            min = r;
+        }
+    }
+    return min;
+}
+
+int Solver::solve(const GameState& state, bool weak) {
+    Position pos = fromState(state);
+    
+    // The game may already be over
+    if (Bitboard::hasAlignment(pos.opponent())) {
+        int score = -(CELLS + 2 - pos.moves) / 2;
+        return weak ? -1 : score;
+    }
+    if (pos.moves >= CELLS) {
+        return 0;
+    }
+    
+    transpositionTable.newSearch();
+    return solvePosition(pos, weak);
+}
+
+vector<int> Solver::analyze(const GameState& state) {
+    vector<int> scores(Bitboard::WIDTH, INVALID_MOVE);
+    Position pos = fromState(state);
+    
+    if (Bitboard::hasAlignment(pos.opponent())) {
+        return scores;
+    }
+    
+    transpositionTable.newSearch();
+    uint64_t winning = Bitboard::winningCells(pos.current, pos.mask);
+    
+    for (int col = 0; col < Bitboard::WIDTH; col++) {
+        uint64_t move = Bitboard::playableCells(pos.mask) & Bitboard::columnMask(col);
+        if (!move) {
+            continue;
+        }
+        
+        if (move & winning) {
+            scores[col] = (CELLS + 1 - pos.moves) / 2;
+        } else if (pos.moves + 1 >= CELLS) {
+            scores[col] = 0;
+        } else {
+            Position child = pos;
+            child.play(move);
+            scores[col] = -solvePosition(child, false);
+        }
+    }
+    
+    return scores;
+}
+
+int Solver::bestMove(const GameState& state, int* score) {
+    vector<int> scores = analyze(state);
+    int best = -1;
+    
+    for (int i = 0; i < Bitboard::WIDTH; i++) {
+        int col = columnOrder[i];
+        if (scores[col] != INVALID_MOVE && (best == -1 || scores[col] > scores[best])) {
+            best = col;
+        }
+    }
+    if (score && best != -1) {
+        *score = scores[best];
+    }
+    return best;
+}
+
+int Solver::pliesToEnd(int score, int moves) {
+    if (score > 0) {
+        // The player to move wins with its (22 - score)-th stone
+        int ownStones = moves / 2;
+        return 2 * (CELLS / 2 + 1 - score - ownStones) - 1;
+    }
+    if (score < 0) {
+        // The opponent wins with its (22 + score)-th stone
+        int opponentStones = (moves + 1) / 2;
+        return 2 * (CELLS / 2 + 1 + score - opponentStones);
+    }
+    return CELLS - moves;
+}
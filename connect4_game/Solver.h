@@ -0,0 +1,81 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "Node.h"
+#include "TranspositionTable.h"
+#include <vector>
+#include <climits>
+
+using namespace std;
+
+// Perfect-play solver for full 7x6 positions.
+// Scores are given from the point of view of the player to move: 0 is a draw,
+// a positive score is a forced win and a negative score a forced loss. The
+// magnitude is 22 minus the number of stones the winner has played when the
+// game ends, so faster wins score higher (see pliesToEnd).
+class Solver {
+public:
+    static const int MIN_SCORE = -(Bitboard::WIDTH * Bitboard::HEIGHT) / 2 + 3;
+    static const int MAX_SCORE = (Bitboard::WIDTH * Bitboard::HEIGHT + 1) / 2 - 3;
+    static const int INVALID_MOVE = INT_MIN;
+
+private:
+    // Position seen from the player to move
+    struct Position {
+        uint64_t current;
+        uint64_t mask;
+        int moves;
+        
+        void play(uint64_t move) {
+            current ^= mask;
+            mask |= move;
+            moves++;
+        }
+        uint64_t opponent() const { return current ^ mask; }
+    };
+    
+    TranspositionTable transpositionTable;
+    long long nodeCount;
+    int columnOrder[Bitboard::WIDTH];
+    
+    // Negamax with alpha-beta pruning, only called on positions without an immediate win
+    int negamax(const Position& pos, int alpha, int beta);
+    
+    // Exact score using a sequence of null-window searches
+    int solvePosition(const Position& pos, bool weak);
+    
+    // Moves that do not hand the opponent an immediate win
+    static uint64_t possibleNonLosingMoves(const Position& pos);
+    
+    static Position fromState(const GameState& state);
+    static uint64_t tableKey(uint64_t positionKey);
+
+public:
+    // Constructor
+    explicit Solver(size_t ttSizeMB = 64);
+    
+    // Player whose turn it is in a state ('X' moves first)
+    static char sideToMove(const GameState& state);
+    
+    // Exact game-theoretic score of a position for the player to move;
+    // a weak solve only reports the sign (-1 loss, 0 draw, 1 win)
+    int solve(const GameState& state, bool weak = false);
+    
+    // Score of every column for the player to move, INVALID_MOVE for full columns
+    vector<int> analyze(const GameState& state);
+    
+    // Best column for the player to move, preferring central columns on ties;
+    // its score is written to score when requested
+    int bestMove(const GameState& state, int* score = nullptr);
+    
+    // Number of plies until the game ends with perfect play, given a score
+    // and the number of moves already played
+    static int pliesToEnd(int score, int moves);
+    
+    // Search statistics and state
+    long long getNodeCount() const { return nodeCount; }
+    void resetNodeCount() { nodeCount = 0; }
+    void reset();
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include "ThreatAnalyzer.h"
+
+template <class Board>
+typename BasicThreatAnalyzer<Board>::Word BasicThreatAnalyzer<Board>::evenCells(Word occupied) {
+    Word empty = Board::boardMask() ^ occupied;
+    Word level = Board::playableCells(occupied);
+    Word even = 0;
+    
+    // Climb two rows at a time; a cell shifted past the top of its column
+    // lands on the sentinel bit, which is never empty
+    for (int distance = 0; distance < Board::HEIGHT; distance += 2) {
+        even |= level;
+        level = (level << 1) & empty;
+        level = (level << 1) & empty;
+    }
+    return even;
+}
+
+template <class Board>
+ThreatVerdict BasicThreatAnalyzer<Board>::analyze(const Board& board, char mover) {
+    Word occupied = board.getMask();
+    Word own = board.stones(mover);
+    Word other = own ^ occupied;
+    Word even = evenCells(occupied);
+    Word odd = (Board::boardMask() ^ occupied) ^ even;
+    Word threats = threatCells(other, occupied) & odd;
+    
+    // The top cell of a column with an odd number of empty cells is at an
+    // even distance
+    Word oddTops = even & (Board::bottomRow() << (Board::HEIGHT - 1));
+    
+    // Cells the mover can still get: the even cells, but in an odd column
+    // only those below the follower's lowest threat there
+    Word reachable = even;
+    for (Word rest = oddTops; rest; rest &= rest - 1) {
+        Word column = Board::columnMask(lowestBit(rest) / Board::COLUMN_BITS);
+        Word columnThreats = threats & column;
+        if (!columnThreats) {
+            return VERDICT_UNKNOWN;
+        }
+        Word lowest = columnThreats & (~columnThreats + 1);
+        reachable &= ~(column & ~(lowest - 1));
+    }
+    
+    if (Board::hasAlignment(own | reachable)) {
+        return VERDICT_UNKNOWN;
+    }
+    if (oddTops || Board::hasAlignment(other | odd)) {
+        return VERDICT_LOSS;
+    }
+    return VERDICT_NO_WIN;
+}
+
+template class BasicThreatAnalyzer<Bitboard>;
+template class BasicThreatAnalyzer<Bitboard8x7>;
+template class BasicThreatAnalyzer<Bitboard9x7>;
+template class BasicThreatAnalyzer<Bitboard9x6Connect5>;
@@ -0,0 +1,55 @@
+#ifndef THREATANALYZER_H
+#define THREATANALYZER_H
+
+#include "Bitboard.h"
+
+using namespace std;
+
+// What the threat rules prove about a position, for the player to move
+enum ThreatVerdict {
+    VERDICT_UNKNOWN,     // No rule applies
+    VERDICT_NO_WIN,      // The player to move cannot win; the other side at least draws
+    VERDICT_LOSS         // The other side wins by force
+};
+
+// Endgame threat-space analysis based on the odd/even (zugzwang) rules.
+//
+// The player who did not move last, called the follower here, can answer
+// every move in the same column ("follow-up"). In a column with an even
+// number of empty cells this gives the follower every cell at an odd
+// distance above the lowest empty cell, and leaves the mover the cells at an
+// even distance. When every column has an even number of empty cells (with
+// six rows: the follower claims the even rows), the mover cannot win if the
+// mover's stones and even cells hold no line, and the follower wins if the
+// follower's stones and odd cells do.
+//
+// A column with an odd number of empty cells breaks the follow-up once the
+// mover takes its top cell, unless the follower has a threat (a cell
+// completing a line) at an odd distance in that column: the follower takes
+// it before the column fills. So with a threat of the follower in every odd
+// column and no line for the mover below those threats, the follower wins
+// (with six rows: the first player's odd threat).
+//
+// Every verdict is a proof, so the search may stop at a proven position.
+// Positions must not be won already.
+template <class Board>
+class BasicThreatAnalyzer {
+public:
+    typedef typename Board::Word Word;
+    
+    // Empty cells that would complete a line for the given stones, on any row
+    static Word threatCells(Word stones, Word occupied) {
+        return Board::winningCells(stones, occupied);
+    }
+    
+    // Empty cells at an even distance above the lowest empty cell of their
+    // column (the playable cells are at distance 0)
+    static Word evenCells(Word occupied);
+    
+    // Apply the rules to a position with the given player to move
+    static ThreatVerdict analyze(const Board& board, char mover);
+};
+
+typedef BasicThreatAnalyzer<Bitboard> ThreatAnalyzer;
+
+#endif
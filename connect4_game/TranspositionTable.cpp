@@ -0,0 +1,98 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(size_t sizeMB) : bucketCount(0), indexMask(0), generation(0) {
+    resize(sizeMB);
+}
+
+void TranspositionTable::resize(size_t sizeMB) {
+    // Round the bucket count down to a power of two so indexing is a mask
+    size_t bytes = max<size_t>(sizeMB, 1) * 1024 * 1024;
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= bytes) {
+        count *= 2;
+    }
+    
+    buckets.reset(new Bucket[count]);
+    bucketCount = count;
+    indexMask = count - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucketCount; i++) {
+        buckets[i].deep.check.store(0, memory_order_relaxed);
+        buckets[i].deep.data.store(0, memory_order_relaxed);
+        buckets[i].recent.check.store(0, memory_order_relaxed);
+        buckets[i].recent.data.store(0, memory_order_relaxed);
+    }
+    generation = 0;
+}
+
+uint64_t TranspositionTable::pack(const TTEntry& entry) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(entry.score)) |
+           static_cast<uint64_t>(static_cast<uint8_t>(entry.depth)) << 32 |
+           static_cast<uint64_t>(entry.bound) << 40 |
+           static_cast<uint64_t>(static_cast<uint8_t>(entry.bestMove)) << 48 |
+           static_cast<uint64_t>(entry.generation) << 56;
+}
+
+TTEntry TranspositionTable::unpack(uint64_t key, uint64_t data) {
+    TTEntry entry;
+    entry.key = key;
+    entry.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+    entry.depth = static_cast<int8_t>(data >> 32);
+    entry.bound = static_cast<uint8_t>(data >> 40);
+    entry.bestMove = static_cast<int8_t>(data >> 48);
+    entry.generation = static_cast<uint8_t>(data >> 56);
+    return entry;
+}
+
+bool TranspositionTable::read(const Slot& slot, uint64_t key, TTEntry& entry) {
+    uint64_t data = slot.data.load(memory_order_relaxed);
+    uint64_t check = slot.check.load(memory_order_relaxed);
+    
+    if ((check ^ data) != key) {
+        return false;
+    }
+    entry = unpack(key, data);
+    return entry.bound != BOUND_NONE;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const Bucket& bucket = buckets[key & indexMask];
+    return read(bucket.deep, key, entry) || read(bucket.recent, key, entry);
+}
+
+void TranspositionTable::store(uint64_t key, int depth, BoundType bound, int score, int bestMove) {
+    Bucket& bucket = buckets[key & indexMask];
+    TTEntry entry = { key, score, static_cast<int8_t>(depth), static_cast<uint8_t>(bound),
+                      static_cast<int8_t>(bestMove), generation };
+    
+    TTEntry deep;
+    bool deepMatches = read(bucket.deep, key, deep);
+    
+    // Keep a known best move when the new result has none
+    if (bestMove < 0) {
+        TTEntry recent;
+        if (deepMatches) {
+            entry.bestMove = deep.bestMove;
+        } else if (read(bucket.recent, key, recent)) {
+            entry.bestMove = recent.bestMove;
+        }
+    }
+    
+    // Depth-preferred slot: take it if empty, stale, the same position or not shallower;
+    // otherwise fall back to the always-replace slot
+    uint64_t deepData = bucket.deep.data.load(memory_order_relaxed);
+    TTEntry current = unpack(0, deepData);
+    Slot* slot = &bucket.recent;
+    if (current.bound == BOUND_NONE || current.generation != generation ||
+        deepMatches || depth >= current.depth) {
+        slot = &bucket.deep;
+    }
+    
+    uint64_t data = pack(entry);
+    slot->data.store(data, memory_order_relaxed);
+    slot->check.store(key ^ data, memory_order_relaxed);
+}
@@ -0,0 +1,84 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+// Kind of score stored for a position
+enum BoundType : uint8_t {
+    BOUND_NONE = 0,
+    BOUND_EXACT = 1,   // Score is the exact minimax value
+    BOUND_LOWER = 2,   // Search failed high: value >= score
+    BOUND_UPPER = 3    // Search failed low: value <= score
+};
+
+// A single cached search result
+struct TTEntry {
+    uint64_t key;
+    int32_t score;
+    int8_t depth;
+    uint8_t bound;
+    int8_t bestMove;
+    uint8_t generation;
+};
+
+// Fixed-size transposition table keyed by Zobrist hashes.
+// Each bucket holds two entries: a depth-preferred slot that keeps the
+// deepest result of the current search and an always-replace slot that
+// receives everything else, so recent shallow results are not lost.
+//
+// The table is shared by all search threads without locks: every slot packs
+// its payload into one 64-bit word and stores key ^ payload next to it, so a
+// torn read from a concurrent write fails the key check and is treated as a miss.
+class TranspositionTable {
+private:
+    struct Slot {
+        atomic<uint64_t> check;
+        atomic<uint64_t> data;
+    };
+    
+    struct Bucket {
+        Slot deep;
+        Slot recent;
+    };
+    
+    unique_ptr<Bucket[]> buckets;
+    size_t bucketCount;
+    uint64_t indexMask;
+    uint8_t generation;
+    
+    static uint64_t pack(const TTEntry& entry);
+    static TTEntry unpack(uint64_t key, uint64_t data);
+    
+    // Read a slot, returns false if it does not hold a valid entry for the key
+    static bool read(const Slot& slot, uint64_t key, TTEntry& entry);
+
+public:
+    // Constructor
+    explicit TranspositionTable(size_t sizeMB = 16);
+    
+    // Reallocate the table with a new size (clears all entries)
+    void resize(size_t sizeMB);
+    
+    // Remove all entries
+    void clear();
+    
+    // Start a new search; entries from older searches become replaceable
+    void newSearch() { generation++; }
+    
+    // Look up a position, returns false when it is not stored
+    bool probe(uint64_t key, TTEntry& entry) const;
+    
+    // Store a search result using the replacement policy
+    void store(uint64_t key, int depth, BoundType bound, int score, int bestMove);
+    
+    // Table geometry
+    size_t getEntryCount() const { return bucketCount * 2; }
+    size_t getSizeBytes() const { return bucketCount * sizeof(Bucket); }
+};
+
+#endif
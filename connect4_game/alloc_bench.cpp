@@ -0,0 +1,163 @@
+#include "AIPlayer.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <climits>
+#include <queue>
+#include <unordered_set>
+#include <new>
+
+using namespace std;
+
+// Allocation benchmark for the BFS evaluation.
+// Counts heap allocations made by AIPlayer::bfsEvaluate, which builds its
+// levels in arenas whose blocks are kept between searches, and by the same
+// search written as a queue walk over node-based standard containers, and
+// times both. Both must visit the same positions and return the same score.
+//
+// Usage: connect4_alloc_bench [repetitions] [depth]
+
+namespace {
+
+long long heapAllocations = 0;
+
+// Fixed positions given as column sequences (1-7), X moves first
+const char* const POSITIONS[] = {
+    "4",
+    "4453",
+    "352364673",
+    "44444326555",
+    "1631326653466",
+    "32756535437447125",
+};
+
+GameState buildPosition(const string& moves) {
+    GameState state;
+    char player = 'X';
+    for (char c : moves) {
+        state = state.makeMove(c - '1', player);
+        player = (player == 'X') ? 'O' : 'X';
+    }
+    return state;
+}
+
+// Canonical key hashing as in AIPlayer
+struct StateHash {
+    size_t operator()(const GameState& state) const {
+        uint64_t key = state.getBoard().canonicalKey();
+        return static_cast<size_t>(key ^ (key >> 29));
+    }
+};
+
+struct StateEqual {
+    bool operator()(const GameState& a, const GameState& b) const {
+        return a.getBoard().canonicalKey() == b.getBoard().canonicalKey();
+    }
+};
+
+// The BFS on the default heap: a std::queue frontier, a std::unordered_set of
+// visited states and a vector of children per expanded node
+int heapBfs(const GameState& startState, int maxDepth, long long& nodes) {
+    queue<GameState> bfsQueue;
+    unordered_set<GameState, StateHash, StateEqual> visited;
+    
+    bfsQueue.push(startState);
+    visited.insert(startState);
+    
+    int bestScore = INT_MIN;
+    nodes = 0;
+    while (!bfsQueue.empty()) {
+        GameState current = bfsQueue.front();
+        bfsQueue.pop();
+        nodes++;
+        
+        bestScore = max(bestScore, current.evaluateState());
+        if (current.getDepth() - startState.getDepth() >= maxDepth || current.isWinningState() || current.isDrawState()) {
+            continue;
+        }
+        
+        char nextPlayer = (current.getLastPlayer() == 'X') ? 'O' : 'X';
+        vector<GameState> nextStates = current.generateNextStates(nextPlayer);
+        for (const GameState& nextState : nextStates) {
+            if (visited.find(nextState) == visited.end()) {
+                visited.insert(nextState);
+                bfsQueue.push(nextState);
+            }
+        }
+    }
+    return bestScore;
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+}
+
+// Count every allocation of the program
+void* operator new(size_t size) {
+    heapAllocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+int main(int argc, char* argv[]) {
+    int repetitions = 20;
+    int depth = 4;
+    if (argc > 1) repetitions = max(1, atoi(argv[1]));
+    if (argc > 2) depth = max(1, atoi(argv[2]));
+    
+    cout << "position,nodes,allocs_heap,allocs_levels,ms_heap,ms_levels,same_result" << endl;
+    
+    // The AI plays 'O', which is what the static evaluation favours; one
+    // thread keeps the thread start-up allocations out of the count
+    AIPlayer ai('O', depth, 1);
+    long long totalHeap = 0;
+    long long totalLevels = 0;
+    bool allSame = true;
+    for (const char* moves : POSITIONS) {
+        GameState state = buildPosition(moves);
+        
+        // The first level search grows its buffers on the heap; later ones reuse them
+        long long before = heapAllocations;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        int heapScore = 0;
+        long long heapNodes = 0;
+        for (int i = 0; i < repetitions; i++) {
+            heapScore = heapBfs(state, depth, heapNodes);
+        }
+        double heapSeconds = secondsSince(start);
+        long long heapCount = heapAllocations - before;
+        
+        before = heapAllocations;
+        start = chrono::steady_clock::now();
+        int levelScore = 0;
+        for (int i = 0; i < repetitions; i++) {
+            levelScore = ai.bfsEvaluate(state);
+        }
+        double levelSeconds = secondsSince(start);
+        long long levelCount = heapAllocations - before;
+        
+        bool same = heapScore == levelScore && heapNodes == ai.getLastNodeCount();
+        totalHeap += heapCount;
+        totalLevels += levelCount;
+        allSame = allSame && same;
+        cout << moves << "," << heapNodes << "," << heapCount << "," << levelCount << "," << fixed << setprecision(3)
+             << heapSeconds * 1000.0 / repetitions << "," << levelSeconds * 1000.0 / repetitions << ","
+             << (same ? "yes" : "no") << endl;
+    }
+    
+    cout << "total,-," << totalHeap << "," << totalLevels << ",-,-," << (allSame ? "yes" : "no") << endl;
+    return allSame ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#include "AIPlayer.h"
+#include "Solver.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+// Search benchmark.
+// Runs fixed-depth searches from a clean table over fixed opening, midgame and
+// endgame suites at every depth up to a maximum and reports, as CSV, the nodes,
+// time to depth, nodes/sec, transposition table hit rate and effective
+// branching factor (nodes at this depth / nodes at the previous depth).
+// Each suite ends with an "all" row per depth summing its positions, and the
+// last row totals the whole run. Node counts are deterministic, so any
+// change in them between builds is a change in the search.
+//
+// Usage: connect4_bench [maxDepth] [suite]
+
+namespace {
+
+struct Suite {
+    const char* name;
+    vector<const char*> positions;   // Column sequences (1-7), X moves first
+};
+
+// No position has an immediate win or forced block, so every search runs
+const Suite SUITES[] = {
+    { "opening", { "4", "44", "4453", "33444", "466537", "5574343" } },
+    { "midgame", { "613457521535", "446336314545", "41355547753344", "33413443766335",
+                   "4145333524543343", "4555323653737564", "377533444446355334" } },
+    { "endgame", { "224523657344343451425611", "545335345443263415146257",
+                   "35256447535535612774644146", "54453451554534674333362712",
+                   "3553444664156612212657176322", "374615444334341511117257525573" } },
+};
+
+GameState buildPosition(const string& moves) {
+    GameState state;
+    char player = 'X';
+    for (char c : moves) {
+        state = state.makeMove(c - '1', player);
+        player = (player == 'X') ? 'O' : 'X';
+    }
+    return state;
+}
+
+struct Measurement {
+    long long nodes;
+    long long probes;
+    long long hits;
+    double seconds;
+    
+    Measurement() : nodes(0), probes(0), hits(0), seconds(0.0) {}
+    
+    void add(const Measurement& other) {
+        nodes += other.nodes;
+        probes += other.probes;
+        hits += other.hits;
+        seconds += other.seconds;
+    }
+};
+
+void printRow(const string& suite, const string& position, int depth, const Measurement& m,
+              long long previousNodes, const string& bestMove, const string& score) {
+    double nps = m.seconds > 0 ? m.nodes / m.seconds : 0.0;
+    double hitRate = m.probes > 0 ? static_cast<double>(m.hits) / m.probes : 0.0;
+    
+    cout << suite << "," << position << "," << depth << "," << m.nodes << ","
+         << fixed << setprecision(3) << m.seconds * 1000.0 << ","
+         << setprecision(0) << nps << "," << setprecision(4) << hitRate << ",";
+    if (previousNodes > 0) {
+        cout << setprecision(3) << static_cast<double>(m.nodes) / previousNodes;
+    } else {
+        cout << "-";
+    }
+    cout << "," << bestMove << "," << score << endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int maxDepth = 12;
+    const char* suiteFilter = nullptr;
+    
+    if (argc > 1) maxDepth = atoi(argv[1]);
+    if (argc > 2) suiteFilter = argv[2];
+    if (maxDepth < 1) maxDepth = 1;
+    
+    cout << "suite,position,depth,nodes,time_ms,nodes_per_sec,tt_hit_rate,branching_factor,best_move,score" << endl;
+    
+    Measurement total;
+    for (const Suite& suite : SUITES) {
+        if (suiteFilter && strcmp(suiteFilter, suite.name) != 0) {
+            continue;
+        }
+        
+        vector<Measurement> perDepth(maxDepth + 1);
+        for (const char* moves : suite.positions) {
+            GameState state = buildPosition(moves);
+            long long previousNodes = 0;
+            
+            for (int depth = 1; depth <= maxDepth; depth++) {
+                AIPlayer ai(Solver::sideToMove(state), depth);
+                
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                int move = ai.getBestMove(state);
+                
+                Measurement m;
+                m.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                m.nodes = ai.getLastNodeCount();
+                m.probes = ai.getLastTableProbes();
+                m.hits = ai.getLastTableHits();
+                perDepth[depth].add(m);
+                
+                printRow(suite.name, moves, depth, m, previousNodes, to_string(move + 1), to_string(ai.getLastScore()));
+                previousNodes = m.nodes;
+            }
+        }
+        
+        for (int depth = 1; depth <= maxDepth; depth++) {
+            printRow(suite.name, "all", depth, perDepth[depth], depth > 1 ? perDepth[depth - 1].nodes : 0, "-", "-");
+            total.add(perDepth[depth]);
+        }
+    }
+    
+    printRow("total", "all", maxDepth, total, 0, "-", "-");
+    return 0;
+}
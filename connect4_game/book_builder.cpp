@@ -0,0 +1,168 @@
+#include "AIPlayer.h"
+#include "OpeningBook.h"
+#include "Solver.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+
+using namespace std;
+
+// Opening book builder.
+// Enumerates every position reachable within a number of plies (mirror images
+// are stored once), picks a move for each with the search or the solver and
+// writes the result as a binary book.
+//
+// Usage: connect4_book_builder [options] output.book
+//   --ply N      deepest position in the book, counted in stones (default 4)
+//   --root M     only positions after the move string M (columns 1-7)
+//   --depth D    search depth used to pick moves (default 10)
+//   --solve      pick moves with the perfect-play solver and store exact scores
+//                (otherwise the search score is stored)
+//   --threads T  worker threads (default: all cores)
+
+namespace {
+
+struct Options {
+    string output;
+    string root;
+    int ply = 4;
+    int depth = 10;
+    bool solve = false;
+    int threads = 1;
+};
+
+// Collect the non-terminal positions up to maxPly, one per canonical key
+void collectPositions(const GameState& state, char player, int maxPly,
+                      unordered_set<uint64_t>& seen, vector<GameState>& positions) {
+    const Bitboard& board = state.getBoard();
+    if (board.getMoveCount() > maxPly || state.isWinningState() || state.isDrawState()) {
+        return;
+    }
+    if (!seen.insert(board.canonicalKey()).second) {
+        return;
+    }
+    positions.push_back(state);
+    
+    char next = (player == 'X') ? 'O' : 'X';
+    for (int col = 0; col < Bitboard::WIDTH; col++) {
+        if (state.isValidMove(col)) {
+            collectPositions(state.makeMove(col, player), next, maxPly, seen, positions);
+        }
+    }
+}
+
+// Pick a move for one position; returns the column and sets the score
+int chooseMove(const GameState& state, const Options& options, Solver* solver, int& score) {
+    char side = Solver::sideToMove(state);
+    score = 0;
+    
+    if (!solver) {
+        AIPlayer ai(side, options.depth);
+        int move = ai.getBestMove(state);
+        score = ai.getLastScore();
+        return move;
+    }
+    
+    // Highest solver score, central columns first on ties
+    return solver->bestMove(state, &score);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    options.threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--ply" && hasValue) {
+            options.ply = atoi(argv[++i]);
+        } else if (arg == "--root" && hasValue) {
+            options.root = argv[++i];
+        } else if (arg == "--depth" && hasValue) {
+            options.depth = atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--solve") {
+            options.solve = true;
+        } else if (arg[0] != '-' && options.output.empty()) {
+            options.output = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.output.empty() && options.ply >= 0 && options.depth > 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        cerr << "Usage: connect4_book_builder [--ply N] [--root MOVES] [--depth D] [--solve] [--threads T] output.book" << endl;
+        return 1;
+    }
+    
+    // Replay the root line
+    GameState root;
+    char player = 'X';
+    for (char c : options.root) {
+        int col = c - '1';
+        if (!root.isValidMove(col) || root.isWinningState()) {
+            cerr << "Invalid root move string: " << options.root << endl;
+            return 1;
+        }
+        root = root.makeMove(col, player);
+        player = (player == 'X') ? 'O' : 'X';
+    }
+    
+    unordered_set<uint64_t> seen;
+    vector<GameState> positions;
+    collectPositions(root, player, options.ply, seen, positions);
+    cout << "Positions: " << positions.size() << endl;
+    
+    // Workers take positions from a shared counter
+    vector<OpeningBook::Entry> entries(positions.size());
+    atomic<size_t> nextIndex(0);
+    atomic<size_t> done(0);
+    
+    auto worker = [&]() {
+        unique_ptr<Solver> solver;
+        if (options.solve) {
+            solver = unique_ptr<Solver>(new Solver());
+        }
+        
+        for (size_t i = nextIndex++; i < positions.size(); i = nextIndex++) {
+            const Bitboard& board = positions[i].getBoard();
+            int score = 0;
+            int move = chooseMove(positions[i], options, solver.get(), score);
+            
+            // Moves are stored for the canonical orientation
+            entries[i].key = board.canonicalKey();
+            entries[i].move = board.isMirroredCanonical() ? Bitboard::WIDTH - 1 - move : move;
+            entries[i].score = score;
+            
+            size_t count = ++done;
+            if (count % 100 == 0 || count == positions.size()) {
+                cerr << "\r" << count << "/" << positions.size() << flush;
+            }
+        }
+    };
+    
+    vector<thread> workers;
+    for (int i = 0; i < options.threads; i++) {
+        workers.push_back(thread(worker));
+    }
+    for (thread& t : workers) {
+        t.join();
+    }
+    cerr << endl;
+    
+    uint64_t flags = options.solve ? OpeningBook::FLAG_EXACT_SCORES : 0;
+    if (!OpeningBook::write(options.output, entries, options.ply, flags)) {
+        cerr << "Could not write " << options.output << endl;
+        return 1;
+    }
+    
+    cout << "Wrote " << entries.size() << " entries to " << options.output << endl;
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "Node.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+
+using namespace std;
+
+// Evaluation benchmark and equivalence check.
+// Plays random games, verifies that the incrementally maintained heuristic of
+// every position matches a full rescan of the board and that the scalar and
+// AVX2 scans agree, then reports evaluations/sec for both scans and for the
+// incremental update.
+//
+// Usage: connect4_eval_bench [games]
+
+namespace {
+
+// Random positions reached by playing random legal moves until the game ends
+vector<GameState> randomPositions(int games, unsigned seed) {
+    mt19937 rng(seed);
+    vector<GameState> positions;
+    
+    for (int g = 0; g < games; g++) {
+        GameState state;
+        char player = 'X';
+        positions.push_back(state);
+        
+        while (!state.isWinningState() && !state.isDrawState()) {
+            int col = rng() % Bitboard::WIDTH;
+            if (!state.isValidMove(col)) continue;
+            state = state.makeMove(col, player);
+            player = (player == 'X') ? 'O' : 'X';
+            positions.push_back(state);
+        }
+    }
+    
+    return positions;
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int games = 20000;
+    if (argc > 1) games = atoi(argv[1]);
+    
+    vector<GameState> positions = randomPositions(games, 12345);
+    
+    // Equivalence: incremental heuristic against both full rescans
+    long long mismatches = 0;
+    for (const GameState& state : positions) {
+        int scalar = Evaluator::evaluateScalar(state.getBoard());
+        if (state.getHeuristic() != scalar || Evaluator::evaluateVector(state.getBoard()) != scalar) {
+            mismatches++;
+        }
+    }
+    cout << "positions," << positions.size() << endl;
+    cout << "mismatches," << mismatches << endl;
+    cout << "vector_scan," << (Evaluator::hasVectorEvaluate() ? "avx2" : "unavailable") << endl;
+    
+    // Full scan of all 69 windows, one at a time
+    long long checksum = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int rep = 0; rep < 10; rep++) {
+        for (const GameState& state : positions) {
+            checksum += Evaluator::evaluateScalar(state.getBoard());
+        }
+    }
+    double fullSeconds = secondsSince(start);
+    
+    // Full scan four windows at a time
+    start = chrono::steady_clock::now();
+    for (int rep = 0; rep < 10; rep++) {
+        for (const GameState& state : positions) {
+            checksum += Evaluator::evaluateVector(state.getBoard());
+        }
+    }
+    double vectorSeconds = secondsSince(start);
+    
+    // Incremental update through the windows of the changed cell only
+    start = chrono::steady_clock::now();
+    long long updates = 0;
+    for (int rep = 0; rep < 10; rep++) {
+        for (size_t i = 1; i < positions.size(); i++) {
+            const GameState& before = positions[i - 1];
+            const GameState& after = positions[i];
+            if (after.getDepth() == 0) continue;
+            uint64_t move = after.getBoard().getMask() ^ before.getBoard().getMask();
+            checksum += Evaluator::moveDelta(before.getBoard(), move, after.getLastPlayer());
+            updates++;
+        }
+    }
+    double incrementalSeconds = secondsSince(start);
+    
+    long long evaluations = 10LL * positions.size();
+    cout << fixed << setprecision(0);
+    cout << "full_scan_evals_per_sec," << evaluations / fullSeconds << endl;
+    cout << "vector_scan_evals_per_sec," << evaluations / vectorSeconds << endl;
+    cout << "incremental_updates_per_sec," << updates / incrementalSeconds << endl;
+    cout << "checksum," << checksum << endl;
+    
+    return mismatches == 0 ? 0 : 1;
+}
@@ -1,5 +1,10 @@
 #include "Connect4.h"
+#include "Solver.h"
+#include "BatchAnalyzer.h"
+#include "EngineServer.h"
 #include <iostream>
+#include <fstream>
+#include <cstdlib>
 #include <limits>
 #include <chrono>
 #include <thread>
@@ -25,6 +30,9 @@ void displayInstructions() {
     cout << "- Get 4 pieces in a row to win!" << endl;
     cout << "- Type 'q' to quit, 'r' to reset, 'i' for info" << endl;
     cout << "- Type 'h' for move history, 'a' to toggle AI" << endl;
+    cout << "- Type 'p' to let the AI think on your time (on by default)" << endl;
+    cout << "- Type 'e' to switch the AI between minimax and Monte Carlo tree search" << endl;
+    cout << "- Type 'u' to take back your last move, 'y' to play it again" << endl;
     cout << "========================================" << endl;
 }
 
@@ -37,6 +45,10 @@ void displayMenu() {
     cout << "h: Show move history" << endl;
     cout << "a: Toggle AI on/off" << endl;
     cout << "d: Change AI difficulty" << endl;
+    cout << "p: Toggle AI pondering" << endl;
+    cout << "e: Switch AI engine (minimax / MCTS)" << endl;
+    cout << "u: Undo your last move" << endl;
+    cout << "y: Redo an undone move" << endl;
     cout << "=================" << endl;
 }
 
@@ -55,6 +67,12 @@ int getPlayerInput(Connect4& game) {
         if (input == "r" || input == "R") {
             return -2; // Reset
         }
+        if (input == "u" || input == "U") {
+            return -3; // Undo
+        }
+        if (input == "y" || input == "Y") {
+            return -4; // Redo
+        }
         if (input == "i" || input == "I") {
             game.displayGameInfo();
             continue;
@@ -69,17 +87,30 @@ int getPlayerInput(Connect4& game) {
             continue;
         }
         if (input == "d" || input == "D") {
-            cout << "Enter AI difficulty (1-6): ";
+            cout << "Enter AI difficulty (1-12): ";
             int difficulty;
             cin >> difficulty;
-            if (difficulty >= 1 && difficulty <= 6) {
+            if (difficulty >= 1 && difficulty <= 12) {
                 game.setAIDifficulty(difficulty);
+                game.startPondering();
                 cout << "AI difficulty set to " << difficulty << endl;
             } else {
                 cout << "Invalid difficulty level!" << endl;
             }
             continue;
         }
+        if (input == "p" || input == "P") {
+            game.setPondering(!game.isPonderingEnabled());
+            game.startPondering();
+            cout << "Pondering " << (game.isPonderingEnabled() ? "enabled" : "disabled") << endl;
+            continue;
+        }
+        if (input == "e" || input == "E") {
+            game.setAIEngine(game.getAIEngine() == ENGINE_MCTS ? ENGINE_MINIMAX : ENGINE_MCTS);
+            game.startPondering();
+            cout << "AI engine: " << (game.getAIEngine() == ENGINE_MCTS ? "Monte Carlo tree search" : "minimax") << endl;
+            continue;
+        }
         if (input == "m" || input == "M") {
             displayMenu();
             continue;
@@ -94,25 +125,20 @@ int getPlayerInput(Connect4& game) {
                 cout << "Please enter a number between 1 and 7." << endl;
             }
         } catch (const invalid_argument&) {
-            cout << "Invalid input. Please enter a number between 1 and 7, or a command (q/r/i/h/a/d)." << endl;
+            cout << "Invalid input. Please enter a number between 1 and 7, or a command (q/r/i/h/a/d/p/e/u/y)." << endl;
         }
     }
 }
 
-void simulateThinking() {
-    cout << "AI is thinking";
-    for (int i = 0; i < 3; i++) {
-        cout << ".";
-        cout.flush();
-        this_thread::sleep_for(chrono::milliseconds(500));
-    }
-    cout << endl;
-}
-
 void playGame() {
     Connect4 game(true); // Enable AI by default
     bool playing = true;
     
+    // Use the opening book next to the game if one has been built
+    if (game.loadOpeningBook("connect4.book")) {
+        cout << "Opening book loaded." << endl;
+    }
+    
     displayWelcome();
     displayInstructions();
     
@@ -121,8 +147,10 @@ void playGame() {
         game.displayGameInfo();
         
         if (game.getCurrentPlayer() == 'X') {
-            // Human player's turn
+            // Human player's turn; the AI searches its replies meanwhile
+            game.startPondering();
             int column = getPlayerInput(game);
+            game.stopPondering();
             
             if (column == -1) { // Quit
                 cout << "\nThanks for playing! Goodbye!" << endl;
@@ -131,6 +159,20 @@ void playGame() {
                 game.resetGame();
                 cout << "\nGame reset! Starting over..." << endl;
                 continue;
+            } else if (column == -3) { // Undo, including the AI's reply
+                if (!game.undoMove()) {
+                    cout << "Nothing to undo." << endl;
+                } else if (game.isAIEnabled() && game.getCurrentPlayer() == 'O') {
+                    game.undoMove();
+                }
+                continue;
+            } else if (column == -4) { // Redo, including the AI's reply
+                if (!game.redoMove()) {
+                    cout << "Nothing to redo." << endl;
+                } else if (game.isAIEnabled() && game.getCurrentPlayer() == 'O' && game.canRedo()) {
+                    game.redoMove();
+                }
+                continue;
             }
             
             // Try to make the move
@@ -143,8 +185,6 @@ void playGame() {
         } else {
             // AI player's turn
             cout << "\nAI's turn..." << endl;
-            simulateThinking();
-            
             if (game.playAIMove()) {
                 cout << "AI made its move!" << endl;
             } else {
@@ -207,11 +247,156 @@ void demonstrateBFS() {
     cout << "=======================" << endl;
 }
 
-int main() {
+void solvePosition() {
+    cout << "\n=== Perfect-Play Solver ===" << endl;
+    cout << "Enter the moves played so far as column numbers (e.g. 4453), or 0 for the empty board: ";
+    
+    string moves;
+    cin >> moves;
+    if (moves == "0") {
+        moves.clear();
+    }
+    
+    GameState state;
+    char player = 'X';
+    for (char c : moves) {
+        int col = c - '1';
+        if (col < 0 || col >= 7 || !state.isValidMove(col) || state.isWinningState()) {
+            cout << "Invalid move sequence!" << endl;
+            return;
+        }
+        state = state.makeMove(col, player);
+        player = (player == 'X') ? 'O' : 'X';
+    }
+    
+    Solver solver;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<int> scores = solver.analyze(state);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    int moveCount = state.getBoard().getMoveCount();
+    int best = -1;
+    cout << "Player to move: " << Solver::sideToMove(state) << endl;
+    for (int col = 0; col < 7; col++) {
+        if (scores[col] == Solver::INVALID_MOVE) continue;
+        cout << "Column " << col + 1 << ": " << scores[col];
+        if (scores[col] > 0) cout << " (win in " << Solver::pliesToEnd(scores[col], moveCount) << " plies)";
+        else if (scores[col] < 0) cout << " (loss in " << Solver::pliesToEnd(scores[col], moveCount) << " plies)";
+        else cout << " (draw)";
+        cout << endl;
+        if (best == -1 || scores[col] > scores[best]) best = col;
+    }
+    
+    if (best != -1) {
+        cout << "Best move: column " << best + 1 << endl;
+    }
+    cout << "Solved in " << seconds << "s (" << solver.getNodeCount() << " nodes)" << endl;
+    cout << "===========================" << endl;
+}
+
+void printUsage() {
+    cerr << "Usage: connect4                           interactive menu" << endl;
+    cerr << "       connect4 --analyze FILE [options]  analyze move strings, one per line ('-' reads stdin)" << endl;
+    cerr << "       connect4 --server                  engine line protocol on stdin/stdout" << endl;
+    cerr << "Options:" << endl;
+    cerr << "  --format csv|jsonl  output format (default csv)" << endl;
+    cerr << "  --depth D           search depth (default 8)" << endl;
+    cerr << "  --movetime MS       iterative deepening with a time budget per position" << endl;
+    cerr << "  --solve             use the perfect-play solver" << endl;
+    cerr << "  --threads T         positions analyzed in parallel (default: all cores)" << endl;
+    cerr << "  --hash MB           table size per thread (default 4)" << endl;
+    cerr << "  --output FILE       write results to a file instead of stdout" << endl;
+    cerr << "  --trace             log every search iteration to stderr (make trace builds)" << endl;
+}
+
+int runAnalysis(int argc, char* argv[]) {
+    AnalysisOptions options;
+    options.threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    string inputPath;
+    string outputPath;
+    
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--analyze" && hasValue) {
+            inputPath = argv[++i];
+        } else if (arg == "--format" && hasValue) {
+            string format = argv[++i];
+            if (format != "csv" && format != "jsonl") {
+                printUsage();
+                return 2;
+            }
+            options.jsonl = (format == "jsonl");
+        } else if (arg == "--depth" && hasValue) {
+            options.depth = max(1, atoi(argv[++i]));
+        } else if (arg == "--movetime" && hasValue) {
+            options.moveTimeMs = max(0, atoi(argv[++i]));
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--hash" && hasValue) {
+            options.hashMB = static_cast<size_t>(max(1, atoi(argv[++i])));
+        } else if (arg == "--output" && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg == "--solve") {
+            options.solve = true;
+        } else if (arg == "--trace") {
+#ifndef SEARCH_TRACE
+            cerr << "Tracing is not compiled in; rebuild with 'make clean trace'" << endl;
+#endif
+            options.trace = true;
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (inputPath.empty()) {
+        printUsage();
+        return 2;
+    }
+    
+    ifstream file;
+    if (inputPath != "-") {
+        file.open(inputPath.c_str());
+        if (!file) {
+            cerr << "Cannot open " << inputPath << endl;
+            return 2;
+        }
+    }
+    ofstream outFile;
+    if (!outputPath.empty()) {
+        outFile.open(outputPath.c_str());
+        if (!outFile) {
+            cerr << "Cannot write " << outputPath << endl;
+            return 2;
+        }
+    }
+    
+    BatchAnalyzer analyzer(options);
+    long long errors = analyzer.run(inputPath != "-" ? static_cast<istream&>(file) : cin,
+                                    outputPath.empty() ? static_cast<ostream&>(cout) : outFile);
+    if (errors > 0) {
+        cerr << errors << " line(s) could not be analyzed" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // Command-line options select the non-interactive modes
+    if (argc > 1 && string(argv[1]) == "--server") {
+        EngineServer server;
+        server.run(cin, cout);
+        return 0;
+    }
+    if (argc > 1) {
+        return runAnalysis(argc, argv);
+    }
+    
     cout << "Choose an option:" << endl;
     cout << "1. Play Connect 4 with AI" << endl;
     cout << "2. Demonstrate BFS Algorithm" << endl;
-    cout << "Enter choice (1 or 2): ";
+    cout << "3. Solve a position" << endl;
+    cout << "Enter choice (1, 2 or 3): ";
     
     int choice;
     cin >> choice;
@@ -220,6 +405,8 @@ int main() {
         playGame();
     } else if (choice == 2) {
         demonstrateBFS();
+    } else if (choice == 3) {
+        solvePosition();
     } else {
         cout << "Invalid choice. Starting game..." << endl;
         playGame();
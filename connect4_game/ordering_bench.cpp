@@ -0,0 +1,106 @@
+#include "AIPlayer.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+using namespace std;
+
+// Move ordering benchmark.
+// Searches a fixed position suite at a fixed depth with move ordering disabled
+// (table move only) and enabled, and reports the node counts of both. With
+// "threats" it compares the search without and with the threat analysis
+// instead, on endgame positions where the threat rules apply.
+//
+// Usage: connect4_ordering_bench [depth] [ordering|threats]
+
+namespace {
+
+// Fixed positions given as column sequences (1-7), X moves first and O (the AI) is to move
+const char* const POSITIONS[] = {
+    "4",
+    "44535",
+    "352364673",
+    "434256715",
+    "677235441",
+    "44444326555",
+    "43132647573",
+    "1234567123456",
+    "1631326653466",
+    "32756535437447125",
+};
+
+// Positions with at least half of the board filled, either side to move
+const char* const ENDGAME_POSITIONS[] = {
+    "333252571521162555127",
+    "2213256476162736677117",
+    "7714242652372231332156",
+    "23216767337756376145564",
+    "224523657344343451425611",
+    "545335345443263415146257",
+    "35256447535535612774644146",
+    "54453451554534674333362712",
+    "3553444664156612212657176322",
+    "374615444334341511117257525573",
+};
+
+GameState buildPosition(const string& moves) {
+    GameState state;
+    char player = 'X';
+    for (char c : moves) {
+        state = state.makeMove(c - '1', player);
+        player = (player == 'X') ? 'O' : 'X';
+    }
+    return state;
+}
+
+// Nodes of a search by the player to move with the feature on or off
+long long countNodes(const GameState& state, int depth, bool threats, bool enabled, int& move) {
+    AIPlayer ai(state.getLastPlayer() == 'X' ? 'O' : 'X', depth, 64);
+    if (threats) {
+        ai.setThreatAnalysis(enabled);
+    } else {
+        ai.setMoveOrdering(enabled);
+    }
+    move = ai.getBestMove(state);
+    return ai.getLastNodeCount();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int depth = 8;
+    bool threats = false;
+    if (argc > 1) depth = atoi(argv[1]);
+    if (argc > 2) threats = string(argv[2]) == "threats";
+    
+    vector<const char*> positions;
+    if (threats) {
+        positions.assign(begin(ENDGAME_POSITIONS), end(ENDGAME_POSITIONS));
+    } else {
+        positions.assign(begin(POSITIONS), end(POSITIONS));
+    }
+    
+    cout << "position,depth,nodes_before,nodes_after,reduction,same_move" << endl;
+    
+    long long totalBefore = 0;
+    long long totalAfter = 0;
+    for (const char* moves : positions) {
+        GameState state = buildPosition(moves);
+        int moveBefore = -1;
+        int moveAfter = -1;
+        long long before = countNodes(state, depth, threats, false, moveBefore);
+        long long after = countNodes(state, depth, threats, true, moveAfter);
+        
+        totalBefore += before;
+        totalAfter += after;
+        cout << moves << "," << depth << "," << before << "," << after << ","
+             << fixed << setprecision(3) << (before > 0 ? 1.0 - static_cast<double>(after) / before : 0.0) << ","
+             << (moveBefore == moveAfter ? "yes" : "no") << endl;
+    }
+    
+    cout << "total," << depth << "," << totalBefore << "," << totalAfter << ","
+         << fixed << setprecision(3) << (totalBefore > 0 ? 1.0 - static_cast<double>(totalAfter) / totalBefore : 0.0)
+         << ",-" << endl;
+    
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include "Node.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cctype>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+// Move generation correctness and throughput tool.
+// Counts the positions reached after exactly N plies from a start position.
+// A game that has ended (four in a row or a full board) is not expanded, so
+// it only counts if it is reached at depth N.
+//
+// Two move generators can be counted:
+//   states    GameState::generateNextStates, makeMove and isWinningState
+//   bitboard  Bitboard::play/unplay and hasAlignment in place
+// --check counts with both and fails if they disagree.
+//
+// Usage: connect4_perft [options] depth [moves]
+//   --divide     print the count below every root move
+//   --threads T  split the root moves over T threads (default: all cores)
+//   --mode M     states or bitboard (default states)
+//   --check      compare both generators
+//   --board B    board variant: 7x6 (default), 8x7, 9x7 or 9x6c5 (connect five)
+
+namespace {
+
+char otherPlayer(char player) {
+    return player == 'X' ? 'O' : 'X';
+}
+
+template <class Board>
+long long perftStates(const BasicGameState<Board>& state, char player, int depth) {
+    if (depth == 0) {
+        return 1;
+    }
+    if (state.isWinningState() || state.isDrawState()) {
+        return 0;
+    }
+    
+    vector<BasicGameState<Board>> children = state.generateNextStates(player);
+    if (depth == 1) {
+        return static_cast<long long>(children.size());
+    }
+    
+    long long count = 0;
+    for (const BasicGameState<Board>& child : children) {
+        count += perftStates(child, otherPlayer(player), depth - 1);
+    }
+    return count;
+}
+
+template <class Board>
+long long perftBoard(Board& board, char player, int depth) {
+    if (depth == 0) {
+        return 1;
+    }
+    if (Board::hasAlignment(board.stones(otherPlayer(player))) || board.isFull()) {
+        return 0;
+    }
+    
+    long long count = 0;
+    for (int col = 0; col < Board::WIDTH; col++) {
+        if (!board.canPlay(col)) {
+            continue;
+        }
+        if (depth == 1) {
+            count++;
+            continue;
+        }
+        board.play(col, player);
+        count += perftBoard(board, otherPlayer(player), depth - 1);
+        board.unplay(col);
+    }
+    return count;
+}
+
+// Count below every root move with the chosen generator, -1 for illegal moves
+template <class Board>
+vector<long long> divide(const BasicGameState<Board>& root, int depth, bool useBoard, int threads) {
+    vector<long long> counts(Board::WIDTH, -1);
+    if (root.isWinningState() || root.isDrawState()) {
+        return counts;
+    }
+    char player = root.getLastPlayer() == 'X' ? 'O' : 'X';
+    
+    // Threads take root moves from a shared counter
+    atomic<int> nextMove(0);
+    auto worker = [&]() {
+        for (int col = nextMove++; col < Board::WIDTH; col = nextMove++) {
+            if (!root.isValidMove(col)) {
+                continue;
+            }
+            if (useBoard) {
+                Board board = root.getBoard();
+                board.play(col, player);
+                counts[col] = perftBoard(board, otherPlayer(player), depth - 1);
+            } else {
+                counts[col] = perftStates(root.makeMove(col, player), otherPlayer(player), depth - 1);
+            }
+        }
+    };
+    
+    vector<thread> workers;
+    for (int i = 1; i < threads; i++) {
+        workers.push_back(thread(worker));
+    }
+    worker();
+    for (thread& t : workers) {
+        t.join();
+    }
+    return counts;
+}
+
+long long total(const vector<long long>& counts) {
+    long long sum = 0;
+    for (long long count : counts) {
+        if (count > 0) sum += count;
+    }
+    return sum;
+}
+
+// Run one generator and print its results; returns the leaf count
+template <class Board>
+long long run(const BasicGameState<Board>& root, int depth, bool useBoard, int threads, bool showDivide) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    long long nodes = 1;
+    vector<long long> counts;
+    if (depth > 0) {
+        counts = divide(root, depth, useBoard, threads);
+        nodes = total(counts);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    if (showDivide) {
+        for (size_t col = 0; col < counts.size(); col++) {
+            if (counts[col] >= 0) {
+                cout << col + 1 << ": " << counts[col] << endl;
+            }
+        }
+    }
+    cout << (useBoard ? "bitboard" : "states") << " depth " << depth << " nodes " << nodes
+         << " time " << fixed << setprecision(3) << seconds << "s nps " << setprecision(0)
+         << (seconds > 0 ? nodes / seconds : 0.0) << endl;
+    return nodes;
+}
+
+// Play a move string (columns from 1, "0" for the empty board) from the
+// start; returns false if it is not a legal unfinished game
+template <class Board>
+bool playMoves(const string& moves, BasicGameState<Board>& state) {
+    char player = 'X';
+    for (size_t i = 0; i < moves.size() && moves != "0"; i++) {
+        int col = moves[i] - '1';
+        if (col < 0 || col >= Board::WIDTH || !state.isValidMove(col) || state.isWinningState()) {
+            return false;
+        }
+        state = state.makeMove(col, player);
+        player = otherPlayer(player);
+    }
+    return true;
+}
+
+// Count on one board variant; returns the exit code
+template <class Board>
+int perft(int depth, const string& moves, bool useBoard, bool check, int threads, bool showDivide) {
+    BasicGameState<Board> root;
+    if (!playMoves(moves, root)) {
+        cerr << "Invalid move sequence: " << moves << endl;
+        return 1;
+    }
+    
+    if (!check) {
+        run(root, depth, useBoard, threads, showDivide);
+        return 0;
+    }
+    
+    long long states = run(root, depth, false, threads, showDivide);
+    long long board = run(root, depth, true, threads, showDivide);
+    if (states != board) {
+        cout << "MISMATCH" << endl;
+        return 1;
+    }
+    cout << "OK" << endl;
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int depth = -1;
+    string moves;
+    bool showDivide = false;
+    bool check = false;
+    bool useBoard = false;
+    string variant = "7x6";
+    int threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--divide") {
+            showDivide = true;
+        } else if (arg == "--check") {
+            check = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--mode" && i + 1 < argc) {
+            string mode = argv[++i];
+            if (mode != "states" && mode != "bitboard") {
+                depth = -2;
+                break;
+            }
+            useBoard = (mode == "bitboard");
+        } else if (arg == "--board" && i + 1 < argc) {
+            variant = argv[++i];
+        } else if (depth == -1 && !arg.empty() && isdigit(static_cast<unsigned char>(arg[0]))) {
+            depth = atoi(arg.c_str());
+        } else if (moves.empty()) {
+            moves = arg;
+        } else {
+            depth = -2;
+            break;
+        }
+    }
+    
+    if (depth >= 0 && variant == "7x6") {
+        return perft<Bitboard>(depth, moves, useBoard, check, threads, showDivide);
+    } else if (depth >= 0 && variant == "8x7") {
+        return perft<Bitboard8x7>(depth, moves, useBoard, check, threads, showDivide);
+    } else if (depth >= 0 && variant == "9x7") {
+        return perft<Bitboard9x7>(depth, moves, useBoard, check, threads, showDivide);
+    } else if (depth >= 0 && variant == "9x6c5") {
+        return perft<Bitboard9x6Connect5>(depth, moves, useBoard, check, threads, showDivide);
+    }
+    
+    cerr << "Usage: connect4_perft [--divide] [--threads T] [--mode states|bitboard] [--check]"
+         << " [--board 7x6|8x7|9x7|9x6c5] depth [moves]" << endl;
+    return 1;
+}
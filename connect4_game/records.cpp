@@ -0,0 +1,252 @@
+#include "GameRecord.h"
+#include "BatchAnalyzer.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+
+using namespace std;
+
+// Game archive converter and replay tool.
+//
+// Usage: connect4_records MODE [options]
+//   --pack IN OUT     convert move strings (columns 1-7, "0" for no moves),
+//                     one game per line, into an archive; with --scores every
+//                     line also holds one engine score per move after the moves
+//   --unpack IN       print the games of an archive as move strings, with
+//                     their scores if the archive has them
+//   --replay IN       replay every game on a board, check that the moves are
+//                     legal and the stored result matches, and report games/sec
+//                     and MB/sec
+//   --generate N OUT  write N random games (scores with --scores are the
+//                     heuristic evaluation after each move)
+//   --scores          store engine scores when packing or generating
+//   --seed S          seed for --generate (default 1)
+
+namespace {
+
+int pack(const string& inPath, const string& outPath, bool withScores) {
+    ifstream in(inPath.c_str());
+    GameRecordWriter writer;
+    if (!in || !writer.open(outPath, withScores)) {
+        cerr << "Cannot open " << (in ? outPath : inPath) << endl;
+        return 1;
+    }
+    
+    string line;
+    long long lineNumber = 0;
+    long long errors = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        istringstream fields(line);
+        string moves;
+        if (!(fields >> moves) || moves[0] == '#') {
+            continue;
+        }
+        
+        GameState state;
+        vector<int> columns;
+        vector<int> scores;
+        int score;
+        while (fields >> score) {
+            scores.push_back(score);
+        }
+        bool ok = BatchAnalyzer::parseMoves(moves, state);
+        for (size_t i = 0; ok && moves != "0" && i < moves.size(); i++) {
+            columns.push_back(moves[i] - '1');
+        }
+        
+        if (!ok || (withScores && scores.size() != columns.size()) || !writer.write(columns, resultOf(state), scores)) {
+            cerr << "Line " << lineNumber << ": invalid game" << endl;
+            errors++;
+        }
+    }
+    
+    if (!writer.close()) {
+        cerr << "Cannot write " << outPath << endl;
+        return 1;
+    }
+    cerr << writer.size() << " games written" << endl;
+    return errors == 0 ? 0 : 1;
+}
+
+int unpack(const string& inPath) {
+    GameRecordReader reader;
+    if (!reader.open(inPath)) {
+        cerr << "Cannot read archive " << inPath << endl;
+        return 1;
+    }
+    
+    GameRecordView game;
+    while (reader.next(game)) {
+        string line = game.moveCount() > 0 ? game.moveString() : "0";
+        for (int ply = 0; game.hasScores() && ply < game.moveCount(); ply++) {
+            line += " " + to_string(game.score(ply));
+        }
+        cout << line << "\n";
+    }
+    
+    if (reader.isDamaged()) {
+        cerr << "Archive is truncated" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int replay(const string& inPath) {
+    GameRecordReader reader;
+    if (!reader.open(inPath)) {
+        cerr << "Cannot read archive " << inPath << endl;
+        return 1;
+    }
+    
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    long long games = 0;
+    long long moves = 0;
+    long long invalid = 0;
+    long long results[4] = { 0, 0, 0, 0 };
+    
+    GameRecordView game;
+    uint8_t columns[256];
+    while (reader.next(game)) {
+        // Play the moves on bare masks (no hashing), checking only that
+        // they are legal; stones[0] are X's
+        uint64_t stones[2] = { 0, 0 };
+        uint64_t mask = 0;
+        uint64_t move = 0;
+        int count = game.moveCount();
+        bool legal = true;
+        game.decodeMoves(columns);
+        for (int ply = 0; ply < count && legal; ply++) {
+            int col = columns[ply];
+            legal = col < Bitboard::WIDTH && (mask & Bitboard::topMask(col)) == 0;
+            move = (mask + Bitboard::bottomMask(col)) & Bitboard::columnMask(col);
+            stones[ply % 2] |= move;
+            mask |= move;
+        }
+        
+        // Stones are never removed, so a line made at any time is still there
+        // at the end: only the last move may have completed one
+        int last = (count + 1) % 2;
+        GameResult result = RESULT_UNKNOWN;
+        if (!legal || Bitboard::hasAlignment(stones[1 - last]) || Bitboard::hasAlignment(stones[last] & ~move)) {
+            legal = false;
+        } else if (count > 0 && Bitboard::hasAlignment(stones[last])) {
+            result = last == 0 ? RESULT_X_WINS : RESULT_O_WINS;
+        } else if (mask == Bitboard::boardMask()) {
+            result = RESULT_DRAW;
+        }
+        
+        if (!legal || (game.result() != RESULT_UNKNOWN && game.result() != result)) {
+            invalid++;
+        }
+        games++;
+        moves += game.moveCount();
+        results[game.result()]++;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    cout << "games," << games << endl;
+    cout << "moves," << moves << endl;
+    cout << "x_wins," << results[RESULT_X_WINS] << endl;
+    cout << "o_wins," << results[RESULT_O_WINS] << endl;
+    cout << "draws," << results[RESULT_DRAW] << endl;
+    cout << "unknown," << results[RESULT_UNKNOWN] << endl;
+    cout << "invalid," << invalid << endl;
+    cout << "bytes," << reader.bytes() << endl;
+    cout << fixed << setprecision(0);
+    cout << "games_per_sec," << (seconds > 0 ? games / seconds : 0.0) << endl;
+    cout << "mb_per_sec," << (seconds > 0 ? reader.bytes() / seconds / 1e6 : 0.0) << endl;
+    
+    if (reader.isDamaged()) {
+        cerr << "Archive is truncated" << endl;
+        return 1;
+    }
+    return invalid == 0 ? 0 : 1;
+}
+
+int generate(long long count, const string& outPath, bool withScores, unsigned long long seed) {
+    GameRecordWriter writer;
+    if (!writer.open(outPath, withScores)) {
+        cerr << "Cannot open " << outPath << endl;
+        return 1;
+    }
+    
+    mt19937_64 rng(seed);
+    vector<int> moves;
+    vector<int> scores;
+    for (long long i = 0; i < count; i++) {
+        GameState state;
+        char player = 'X';
+        moves.clear();
+        scores.clear();
+        while (!state.isWinningState() && !state.isDrawState()) {
+            int col = static_cast<int>(rng() % Bitboard::WIDTH);
+            if (!state.isValidMove(col)) {
+                continue;
+            }
+            state = state.makeMove(col, player);
+            moves.push_back(col);
+            scores.push_back(state.evaluateState());
+            player = (player == 'X') ? 'O' : 'X';
+        }
+        writer.write(moves, resultOf(state), scores);
+    }
+    
+    if (!writer.close()) {
+        cerr << "Cannot write " << outPath << endl;
+        return 1;
+    }
+    cerr << writer.size() << " games written" << endl;
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    string mode;
+    string inPath;
+    string outPath;
+    long long count = 0;
+    bool withScores = false;
+    unsigned long long seed = 1;
+    bool ok = true;
+    
+    for (int i = 1; i < argc && ok; i++) {
+        string arg = argv[i];
+        if (arg == "--pack" && i + 2 < argc) {
+            mode = arg;
+            inPath = argv[++i];
+            outPath = argv[++i];
+        } else if (arg == "--generate" && i + 2 < argc) {
+            mode = arg;
+            count = atoll(argv[++i]);
+            outPath = argv[++i];
+        } else if ((arg == "--unpack" || arg == "--replay") && i + 1 < argc) {
+            mode = arg;
+            inPath = argv[++i];
+        } else if (arg == "--scores") {
+            withScores = true;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else {
+            ok = false;
+        }
+    }
+    
+    if (ok && mode == "--pack") {
+        return pack(inPath, outPath, withScores);
+    } else if (ok && mode == "--unpack") {
+        return unpack(inPath);
+    } else if (ok && mode == "--replay") {
+        return replay(inPath);
+    } else if (ok && mode == "--generate" && count > 0) {
+        return generate(count, outPath, withScores, seed);
+    }
+    
+    cerr << "Usage: connect4_records --pack IN OUT | --unpack IN | --replay IN | --generate N OUT"
+         << " [--scores] [--seed S]" << endl;
+    return 1;
+}
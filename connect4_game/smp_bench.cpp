@@ -0,0 +1,76 @@
+#include "AIPlayer.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+using namespace std;
+
+// Thread scaling benchmark for the Lazy SMP search.
+// Runs the same time-budgeted searches with 1..N threads and reports nodes/sec.
+//
+// Usage: connect4_smp_bench [maxThreads] [millisecondsPerPosition]
+
+namespace {
+
+// Fixed positions given as column sequences (1-7), X moves first and O (the AI) is to move
+const char* const POSITIONS[] = {
+    "4",
+    "44535",
+    "444433221",
+    "445566732",
+    "434256715",
+};
+
+GameState buildPosition(const string& moves) {
+    GameState state;
+    char player = 'X';
+    for (char c : moves) {
+        state = state.makeMove(c - '1', player);
+        player = (player == 'X') ? 'O' : 'X';
+    }
+    return state;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int maxThreads = static_cast<int>(thread::hardware_concurrency());
+    int budgetMs = 1000;
+    
+    if (argc > 1) maxThreads = atoi(argv[1]);
+    if (argc > 2) budgetMs = atoi(argv[2]);
+    if (maxThreads < 1) maxThreads = 1;
+    
+    cout << "threads,nodes,seconds,nodes_per_sec,speedup" << endl;
+    
+    // Powers of two up to the requested maximum, which is always included
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+    
+    double baseline = 0.0;
+    for (int threads : threadCounts) {
+        long long nodes = 0;
+        double seconds = 0.0;
+        
+        for (const char* moves : POSITIONS) {
+            GameState state = buildPosition(moves);
+            AIPlayer ai('O', 4, 64, threads);
+            
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            ai.getBestMove(state, chrono::milliseconds(budgetMs));
+            seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            nodes += ai.getLastNodeCount();
+        }
+        
+        double nps = seconds > 0 ? nodes / seconds : 0.0;
+        if (threads == 1) baseline = nps;
+        
+        cout << threads << "," << nodes << "," << fixed << setprecision(3) << seconds << ","
+             << setprecision(0) << nps << "," << setprecision(2) << (baseline > 0 ? nps / baseline : 0.0) << endl;
+    }
+    
+    return 0;
+}
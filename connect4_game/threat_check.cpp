@@ -0,0 +1,150 @@
+#include "Solver.h"
+#include "ThreatAnalyzer.h"
+#include "BatchAnalyzer.h"
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <random>
+
+using namespace std;
+
+// Threat analysis validation.
+// Runs the odd/even threat rules over a corpus of positions and checks every
+// verdict against the exact result of the solver: a proven loss must be a
+// loss, and a position where the player to move cannot win must not be a win.
+// Reports how often each verdict applies and fails if any verdict is wrong.
+// --weak-check also solves every position weakly and strongly and fails if
+// the weak result is not the sign of the strong score.
+//
+// Usage: connect4_threat_check [options]
+//   --positions FILE  move strings (columns 1-7), one per line
+//   --random N        otherwise N random positions (default 20000)
+//   --plies A-B       played by random moves, from A to B plies (default 24-38)
+//   --seed S          seed for the random positions (default 1)
+//   --weak-check      compare weak and strong solves on every position
+
+namespace {
+
+char otherPlayer(char player) {
+    return player == 'X' ? 'O' : 'X';
+}
+
+// Random position with the given number of plies that has not ended
+GameState randomPosition(mt19937_64& rng, int plies) {
+    while (true) {
+        GameState state;
+        char player = 'X';
+        for (int i = 0; i < plies && !state.isWinningState() && !state.isDrawState(); i++) {
+            int col;
+            do {
+                col = static_cast<int>(rng() % Bitboard::WIDTH);
+            } while (!state.isValidMove(col));
+            state = state.makeMove(col, player);
+            player = otherPlayer(player);
+        }
+        if (!state.isWinningState() && !state.isDrawState()) {
+            return state;
+        }
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    string positionsPath;
+    int randomCount = 20000;
+    int minPlies = 24;
+    int maxPlies = 38;
+    unsigned long long seed = 1;
+    bool weakCheck = false;
+    
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool ok = hasValue;
+        if (arg == "--weak-check") {
+            weakCheck = true;
+            ok = true;
+        } else if (arg == "--positions" && hasValue) {
+            positionsPath = argv[++i];
+        } else if (arg == "--random" && hasValue) {
+            randomCount = atoi(argv[++i]);
+        } else if (arg == "--plies" && hasValue) {
+            string range = argv[++i];
+            size_t dash = range.find('-');
+            minPlies = atoi(range.c_str());
+            maxPlies = dash == string::npos ? minPlies : atoi(range.c_str() + dash + 1);
+            ok = minPlies >= 0 && maxPlies >= minPlies;
+        } else if (arg == "--seed" && hasValue) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            cerr << "Usage: connect4_threat_check [--positions FILE] [--random N] [--plies A-B] [--seed S] [--weak-check]" << endl;
+            return 1;
+        }
+    }
+    
+    vector<GameState> corpus;
+    if (!positionsPath.empty()) {
+        ifstream file(positionsPath.c_str());
+        string line;
+        while (getline(file, line)) {
+            GameState state;
+            if (!line.empty() && line[0] != '#' && BatchAnalyzer::parseMoves(line, state) &&
+                !state.isWinningState() && !state.isDrawState()) {
+                corpus.push_back(state);
+            }
+        }
+    } else {
+        mt19937_64 rng(seed);
+        for (int i = 0; i < randomCount; i++) {
+            corpus.push_back(randomPosition(rng, minPlies + static_cast<int>(rng() % (maxPlies - minPlies + 1))));
+        }
+    }
+    
+    // Only positions with a verdict need solving
+    Solver solver;
+    long long losses = 0;
+    long long noWins = 0;
+    long long wrong = 0;
+    long long weakMismatches = 0;
+    for (const GameState& state : corpus) {
+        if (weakCheck) {
+            int weak = solver.solve(state, true);
+            int strong = solver.solve(state, false);
+            if (weak != (strong > 0) - (strong < 0)) {
+                weakMismatches++;
+                cout << "weak_mismatch,weak " << weak << ",strong " << strong << endl;
+            }
+        }
+        
+        ThreatVerdict verdict = ThreatAnalyzer::analyze(state.getBoard(), Solver::sideToMove(state));
+        if (verdict == VERDICT_UNKNOWN) {
+            continue;
+        }
+        
+        int result = solver.solve(state, true);
+        bool correct = (verdict == VERDICT_LOSS) ? result < 0 : result <= 0;
+        if (verdict == VERDICT_LOSS) {
+            losses++;
+        } else {
+            noWins++;
+        }
+        if (!correct) {
+            wrong++;
+            cout << "wrong," << (verdict == VERDICT_LOSS ? "loss" : "no_win") << ",solver " << result << endl;
+        }
+    }
+    
+    cout << "positions," << corpus.size() << endl;
+    cout << "proven_losses," << losses << endl;
+    cout << "proven_no_wins," << noWins << endl;
+    cout << "wrong," << wrong << endl;
+    if (weakCheck) {
+        cout << "weak_mismatches," << weakMismatches << endl;
+    }
+    
+    return wrong == 0 && weakMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,325 @@
+#include "AIPlayer.h"
+#include "MCTSPlayer.h"
+#include "BatchAnalyzer.h"
+#include "GameRecord.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+
+using namespace std;
+
+// Self-play tournament between two engine configurations.
+// Every opening is played twice with colours swapped; games are spread over
+// worker threads. Reports wins/draws/losses of engine A, its Elo difference
+// to B with a 95% confidence interval, and the average time per move. An
+// engine that returns an illegal move loses the game; such moves are
+// reported and counted in the summary, the game is recorded unfinished and
+// the tool exits with status 1.
+//
+// Usage: connect4_tournament [options]
+//   --a SPEC, --b SPEC  engine settings as key=value pairs separated by commas:
+//                       depth=N, movetime=MS (iterative deepening instead of a
+//                       fixed depth), ordering=0|1, threats=0|1 (threat
+//                       analysis), threads=N, hash=MB, mcts=0|1 (Monte Carlo
+//                       tree search instead of minimax; hash is then its tree
+//                       memory), playouts=N (MCTS budget without movetime)
+//                       (default: depth=6 for both)
+//   --games N           number of games, rounded up to an even count (default 200)
+//   --openings FILE     move strings (columns 1-7), one per line, used in turn
+//   --random-plies K    otherwise open with K random moves (default 4)
+//   --seed S            seed for the random openings (default 1)
+//   --threads T         games played in parallel (default: all cores)
+//   --record FILE       save every game to a game archive, with the score each
+//                       engine gave its moves (0 for opening moves)
+
+namespace {
+
+struct EngineConfig {
+    int depth = 6;
+    int moveTimeMs = 0;
+    bool ordering = true;
+    bool threats = true;
+    int threads = 1;
+    size_t hashMB = 16;
+    bool mcts = false;
+    long long playouts = 20000;
+    string spec = "depth=6";
+};
+
+struct EngineTotals {
+    long long moves = 0;
+    double seconds = 0.0;
+    int illegalMoves = 0;
+};
+
+bool parseEngine(const string& spec, EngineConfig& config) {
+    config.spec = spec;
+    stringstream in(spec);
+    string item;
+    while (getline(in, item, ',')) {
+        size_t eq = item.find('=');
+        if (eq == string::npos) {
+            return false;
+        }
+        string key = item.substr(0, eq);
+        int value = atoi(item.c_str() + eq + 1);
+        if (key == "depth" && value > 0) {
+            config.depth = value;
+        } else if (key == "movetime" && value >= 0) {
+            config.moveTimeMs = value;
+        } else if (key == "ordering") {
+            config.ordering = value != 0;
+        } else if (key == "threats") {
+            config.threats = value != 0;
+        } else if (key == "threads" && value > 0) {
+            config.threads = value;
+        } else if (key == "hash" && value > 0) {
+            config.hashMB = static_cast<size_t>(value);
+        } else if (key == "mcts") {
+            config.mcts = value != 0;
+        } else if (key == "playouts" && value > 0) {
+            config.playouts = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+unique_ptr<Engine> createEngine(const EngineConfig& config, char symbol) {
+    if (config.mcts) {
+        return unique_ptr<Engine>(new MCTSPlayer(symbol, config.playouts, config.hashMB, config.threads));
+    }
+    unique_ptr<AIPlayer> ai(new AIPlayer(symbol, config.depth, config.hashMB, config.threads));
+    ai->setMoveOrdering(config.ordering);
+    ai->setThreatAnalysis(config.threats);
+    return unique_ptr<Engine>(ai.release());
+}
+
+// Random legal opening that does not end the game
+string randomOpening(mt19937_64& rng, int plies) {
+    while (true) {
+        GameState state;
+        string moves;
+        char player = 'X';
+        for (int i = 0; i < plies && !state.isWinningState() && !state.isDrawState(); i++) {
+            int col;
+            do {
+                col = static_cast<int>(rng() % Bitboard::WIDTH);
+            } while (!state.isValidMove(col));
+            state = state.makeMove(col, player);
+            moves += static_cast<char>('1' + col);
+            player = (player == 'X') ? 'O' : 'X';
+        }
+        if (!state.isWinningState() && !state.isDrawState()) {
+            return moves;
+        }
+    }
+}
+
+// Elo difference for a score fraction
+double eloFromScore(double score) {
+    score = min(max(score, 1e-6), 1.0 - 1e-6);
+    return -400.0 * log10(1.0 / score - 1.0);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    EngineConfig configs[2];
+    int games = 200;
+    int randomPlies = 4;
+    unsigned long long seed = 1;
+    int threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    string openingsPath;
+    string recordPath;
+    
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool ok = hasValue;
+        if (arg == "--a" && hasValue) {
+            ok = parseEngine(argv[++i], configs[0]);
+        } else if (arg == "--b" && hasValue) {
+            ok = parseEngine(argv[++i], configs[1]);
+        } else if (arg == "--games" && hasValue) {
+            games = atoi(argv[++i]);
+        } else if (arg == "--openings" && hasValue) {
+            openingsPath = argv[++i];
+        } else if (arg == "--random-plies" && hasValue) {
+            randomPlies = atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && hasValue) {
+            threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--record" && hasValue) {
+            recordPath = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            cerr << "Usage: connect4_tournament [--a SPEC] [--b SPEC] [--games N] [--openings FILE]"
+                 << " [--random-plies K] [--seed S] [--threads T] [--record FILE]" << endl;
+            return 1;
+        }
+    }
+    games = max(2, games + games % 2);
+    
+    // One opening per pair of games
+    vector<string> openings;
+    if (!openingsPath.empty()) {
+        ifstream file(openingsPath.c_str());
+        string line;
+        while (getline(file, line)) {
+            GameState state;
+            if (!line.empty() && line[0] != '#' && BatchAnalyzer::parseMoves(line, state) &&
+                !state.isWinningState() && !state.isDrawState()) {
+                openings.push_back(line == "0" ? string() : line);
+            }
+        }
+        if (openings.empty()) {
+            cerr << "No usable openings in " << openingsPath << endl;
+            return 1;
+        }
+    } else {
+        mt19937_64 rng(seed);
+        for (int i = 0; i < games / 2; i++) {
+            openings.push_back(randomOpening(rng, randomPlies));
+        }
+    }
+    
+    GameRecordWriter recorder;
+    if (!recordPath.empty() && !recorder.open(recordPath, true)) {
+        cerr << "Cannot write " << recordPath << endl;
+        return 1;
+    }
+    
+    // Results from engine A's point of view
+    atomic<int> nextGame(0);
+    atomic<int> finished(0);
+    mutex resultMutex;
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    EngineTotals totals[2];
+    
+    auto worker = [&]() {
+        // Engines indexed by [config][symbol], reused with a cleared table per game
+        unique_ptr<Engine> engines[2][2];
+        for (int c = 0; c < 2; c++) {
+            engines[c][0] = createEngine(configs[c], 'X');
+            engines[c][1] = createEngine(configs[c], 'O');
+        }
+        
+        for (int game = nextGame++; game < games; game = nextGame++) {
+            // Engine A plays X in even games and O in odd ones
+            int configOfX = game % 2;
+            Engine* players[2] = { engines[configOfX][0].get(), engines[1 - configOfX][1].get() };
+            EngineTotals local[2];
+            for (Engine* ai : players) {
+                ai->newGame();
+            }
+            
+            GameState state;
+            const string& opening = openings[(game / 2) % openings.size()];
+            BatchAnalyzer::parseMoves(opening, state);
+            vector<int> moves;
+            vector<int> scores;
+            for (char c : opening) {
+                moves.push_back(c - '1');
+                scores.push_back(0);
+            }
+            int side = state.getBoard().getMoveCount() % 2;
+            int forfeit = -1;   // Config that played an illegal move
+            while (!state.isWinningState() && !state.isDrawState()) {
+                int config = (side == 0) ? configOfX : 1 - configOfX;
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                int move = configs[config].moveTimeMs > 0
+                    ? players[side]->getBestMove(state, chrono::milliseconds(configs[config].moveTimeMs))
+                    : players[side]->getBestMove(state);
+                local[config].seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                local[config].moves++;
+                
+                if (!state.isValidMove(move)) {
+                    local[config].illegalMoves++;
+                    forfeit = config;
+                    break;
+                }
+                state = state.makeMove(move, side == 0 ? 'X' : 'O');
+                moves.push_back(move);
+                scores.push_back(players[side]->getLastStats().score);
+                side = 1 - side;
+            }
+            
+            lock_guard<mutex> lock(resultMutex);
+            if (forfeit >= 0) {
+                cerr << "\rIllegal move by engine " << (forfeit == 0 ? "A" : "B") << " at ply " << moves.size() + 1
+                     << " of game " << game + 1 << endl;
+                if (forfeit == 0) {
+                    losses++;
+                } else {
+                    wins++;
+                }
+            } else if (!state.isWinningState()) {
+                draws++;
+            } else if ((state.getLastPlayer() == 'X') == (configOfX == 0)) {
+                wins++;
+            } else {
+                losses++;
+            }
+            for (int c = 0; c < 2; c++) {
+                totals[c].moves += local[c].moves;
+                totals[c].seconds += local[c].seconds;
+                totals[c].illegalMoves += local[c].illegalMoves;
+            }
+            if (recorder.isOpen()) {
+                recorder.write(moves, resultOf(state), scores);
+            }
+            
+            int done = ++finished;
+            if (done % 10 == 0 || done == games) {
+                cerr << "\r" << done << "/" << games << " games  +" << wins << " =" << draws << " -" << losses << flush;
+            }
+        }
+    };
+    
+    vector<thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(thread(worker));
+    }
+    for (thread& t : workers) {
+        t.join();
+    }
+    cerr << endl;
+    if (recorder.isOpen() && !recorder.close()) {
+        cerr << "Cannot write " << recordPath << endl;
+    }
+    
+    // Elo with a 95% confidence interval from the per-game score variance
+    int n = wins + draws + losses;
+    double score = (wins + 0.5 * draws) / n;
+    double variance = (wins * pow(1.0 - score, 2) + draws * pow(0.5 - score, 2) + losses * pow(score, 2)) / n;
+    double margin = 1.96 * sqrt(variance / n);
+    
+    cout << "Engine A: " << configs[0].spec << endl;
+    cout << "Engine B: " << configs[1].spec << endl;
+    cout << "Games: " << n << " (" << openings.size() << " openings, both colours)" << endl;
+    cout << "A wins/draws/losses: " << wins << " / " << draws << " / " << losses << endl;
+    cout << fixed << setprecision(1);
+    cout << "Score: " << score * 100.0 << "%" << endl;
+    cout << "Elo (A - B): " << eloFromScore(score) << "  95% CI [" << eloFromScore(score - margin)
+         << ", " << eloFromScore(score + margin) << "]" << endl;
+    cout << setprecision(3);
+    for (int c = 0; c < 2; c++) {
+        cout << "Average time per move " << (c == 0 ? "A" : "B") << ": "
+             << (totals[c].moves > 0 ? totals[c].seconds * 1000.0 / totals[c].moves : 0.0) << " ms ("
+             << totals[c].moves << " moves)" << endl;
+    }
+    cout << "Illegal moves A/B: " << totals[0].illegalMoves << " / " << totals[1].illegalMoves << endl;
+    
+    return totals[0].illegalMoves + totals[1].illegalMoves == 0 ? 0 : 1;
+}